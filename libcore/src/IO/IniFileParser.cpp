@@ -217,6 +217,13 @@ bool IniFileParser::ParseHeader(TiXmlNode * xHeader)
         LOG_INFO("Show statistics: {}", value);
     }
 
+    // order of the agents after removing agents
+    if(xHeader->FirstChild("stable_agent_order")) {
+        std::string value = xHeader->FirstChild("stable_agent_order")->FirstChild()->Value();
+        _config->SetStableAgentOrder(value == "true");
+        LOG_INFO("Stable agent order: {}", value);
+    }
+
     // Results Output Path
     auto * xmlOutput = xHeader->FirstChildElement("output");
     if(xmlOutput != nullptr) {
@@ -479,6 +486,11 @@ bool IniFileParser::ParseGCFMModel(TiXmlElement * xGCFM, TiXmlElement * xMainNod
             std::stod(dist_max),
             std::stod(disteff_max),
             std::stod(interpolation_width));
+        const char * pairwise = xModelPara->FirstChildElement("force_ped")->Attribute("pairwise");
+        if(pairwise) {
+            _config->SetPairwiseForcePed(std::string(pairwise) == "true");
+            LOG_INFO("Frep_ped pairwise={}", _config->GetPairwiseForcePed());
+        }
     }
 
     //force_wall
@@ -500,6 +512,22 @@ bool IniFileParser::ParseGCFMModel(TiXmlElement * xGCFM, TiXmlElement * xMainNod
             std::stod(dist_max),
             std::stod(disteff_max),
             std::stod(interpolation_width));
+        const char * cutoff = xModelPara->FirstChildElement("force_wall")->Attribute("cutoff");
+        if(cutoff) {
+            _config->SetWallCutoff(std::stod(cutoff));
+            LOG_INFO("Frep_wall cutoff={:.3f}", _config->GetWallCutoff());
+        }
+    }
+
+    //max_substeps
+    if(xModelPara->FirstChild("max_substeps")) {
+        const char * maxSubSteps = xModelPara->FirstChild("max_substeps")->FirstChild()->Value();
+        _config->SetMaxSubSteps(atoi(maxSubSteps));
+        if(_config->GetMaxSubSteps() < 1) {
+            LOG_ERROR("max_substeps must be at least 1, got <{}>", maxSubSteps);
+            return false;
+        }
+        LOG_INFO("Max substeps <{}>", _config->GetMaxSubSteps());
     }
 
     //Parsing the agent parameters
@@ -516,7 +544,10 @@ bool IniFileParser::ParseGCFMModel(TiXmlElement * xGCFM, TiXmlElement * xMainNod
         _config->GetIntPWidthPed(),
         _config->GetIntPWidthWall(),
         _config->GetMaxFPed(),
-        _config->GetMaxFWall())));
+        _config->GetMaxFWall(),
+        _config->GetWallCutoff(),
+        _config->GetPairwiseForcePed(),
+        _config->GetMaxSubSteps())));
 
     return true;
 }
@@ -591,6 +622,18 @@ bool IniFileParser::ParseVelocityModel(TiXmlElement * xVelocity, TiXmlElement *
             _config->SetDWall(std::stod(D));
         }
         LOG_INFO("Frep_wall a={:.2f}, D={:.2f}", _config->GetaWall(), _config->GetDWall());
+        const char * cutoff = xModelPara->FirstChildElement("force_wall")->Attribute("cutoff");
+        if(cutoff) {
+            _config->SetWallCutoff(std::stod(cutoff));
+            LOG_INFO("Frep_wall cutoff={:.2f}", _config->GetWallCutoff());
+        }
+    }
+
+    //fast_math
+    if(xModelPara->FirstChild("fast_math")) {
+        std::string value = xModelPara->FirstChild("fast_math")->FirstChild()->Value();
+        _config->SetFastMath(value == "true");
+        LOG_INFO("Fast math: {}", value);
     }
 
     //Parsing the agent parameters
@@ -601,7 +644,9 @@ bool IniFileParser::ParseVelocityModel(TiXmlElement * xVelocity, TiXmlElement *
         _config->GetaPed(),
         _config->GetDPed(),
         _config->GetaWall(),
-        _config->GetDWall())));
+        _config->GetDWall(),
+        _config->GetWallCutoff(),
+        _config->GetFastMath())));
 
     return true;
 }
@@ -930,6 +975,33 @@ bool IniFileParser::ParseLinkedCells(const TiXmlNode & linkedCellNode)
         if(linkedcells == "true") {
             _config->SetLinkedCellSize(std::stod(cell_size));
             LOG_INFO("Linked cells enabled with size  <{:.2f}>", _config->GetLinkedCellSize());
+
+            // optional Verlet lists on top of the linked cells
+            const char * verlet_skin =
+                linkedCellNode.FirstChildElement("linkedcells")->Attribute("verlet_skin");
+            if(verlet_skin) {
+                _config->SetVerletSkin(std::stod(verlet_skin));
+                LOG_INFO("Verlet lists enabled with skin <{:.2f}>", _config->GetVerletSkin());
+            }
+
+            // optional spatial sorting of the agents along the linked cells
+            const char * sort_interval =
+                linkedCellNode.FirstChildElement("linkedcells")->Attribute("sort_interval");
+            if(sort_interval) {
+                _config->SetAgentSortInterval(xmltoi(sort_interval, 0));
+                LOG_INFO(
+                    "Agents are sorted spatially every <{}> time steps",
+                    _config->GetAgentSortInterval());
+            }
+
+            // optional separation of the floors
+            const char * elevation_band =
+                linkedCellNode.FirstChildElement("linkedcells")->Attribute("elevation_band");
+            if(elevation_band) {
+                _config->SetElevationBand(std::stod(elevation_band));
+                LOG_INFO(
+                    "Linked cells use elevation bands of <{:.2f}>", _config->GetElevationBand());
+            }
             return true;
         } else {
             _config->SetLinkedCellSize(-1.0);
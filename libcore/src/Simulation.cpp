@@ -123,6 +123,8 @@ bool Simulation::InitArgs()
     //this should be called after the routing engine has been initialised
     // because a direction is needed for this initialisation.
     LOG_INFO("Init Operational Model starting ...");
+    // the routers may query the neighbourhood of the pedestrians
+    _building->UpdateGrid();
     if(!_operationalModel->Init(_building.get())) {
         return false;
     }
@@ -216,15 +218,22 @@ void Simulation::UpdateRoutesAndLocations()
 
     _routingEngine->setNeedUpdate(geometryChangedFlow || geometryChangedTrain);
 
+    // the routers query the pedestrians at their new positions and subrooms
+    _building->UpdateGrid();
+
     //TODO check if better move to main loop, does not belong here
     UpdateRoutes();
 }
 
 void Simulation::UpdateRoutes()
 {
-    for(auto ped : _building->GetAllPedestrians()) {
+    const auto & peds  = _building->GetAllPedestrians();
+    const auto targets = SimulationHelper::FindReentrantRoutes(peds);
+
+    for(size_t i = 0; i < peds.size(); ++i) {
+        auto ped = peds[i];
         // set ped waiting, if no target is found
-        int target = ped->FindRoute();
+        int target = targets[i] ? *targets[i] : ped->FindRoute();
 
         if(target == FINAL_DEST_OUT) {
             ped->StartWaiting();
@@ -382,6 +391,12 @@ double Simulation::RunBody(double maxSimTime)
         AddNewAgents();
 
         if(t > Pedestrian::GetMinPremovementTime()) {
+            //keep neighbouring agents close in memory
+            const int sortInterval = _config->GetAgentSortInterval();
+            if(sortInterval > 0 && frameNr % sortInterval == 0) {
+                _building->SortPedestriansSpatially();
+            }
+
             //update the linked cells
             _building->UpdateGrid();
 
@@ -19,18 +19,105 @@
  **/
 #include "SimulationHelper.h"
 
+#include "general/OpenMP.h"
 #include "geometry/Room.h"
 #include "geometry/SubRoom.h"
+#include "routing/Router.h"
 
 #include <Logger.h>
 #include <algorithm>
+#include <cstddef>
+
+namespace
+{
+/// Line::IntersectionWith() accepts intersections up to 5% of the step behind its start
+constexpr double STEP_EXTENSION = 0.05;
+
+/// transitions of all subrooms of room, in the order of the subrooms
+std::vector<SimulationHelper::RoomTransition> CollectTransitions(const Room & room)
+{
+    std::vector<SimulationHelper::RoomTransition> transitions;
+    for(auto const & [subroomID, subroom] : room.GetAllSubRooms()) {
+        for(auto trans : subroom->GetAllTransitions()) {
+            const Point & p1 = trans->GetPoint1();
+            const Point & p2 = trans->GetPoint2();
+            transitions.push_back(
+                {trans,
+                 std::min(p1._x, p2._x),
+                 std::min(p1._y, p2._y),
+                 std::max(p1._x, p2._x),
+                 std::max(p1._y, p2._y)});
+        }
+    }
+    return transitions;
+}
+
+/// first transition of transitions passed by ped in the last step, see FindPassedDoor()
+std::optional<Transition *> FindPassedTransition(
+    const std::vector<SimulationHelper::RoomTransition> & transitions,
+    const Pedestrian & ped)
+{
+    const Point & from = ped.GetLastPosition();
+    const Point & to   = ped.GetPos();
+
+    // transitions outside of the bounding box of the step cannot intersect it, the margin covers
+    // the tolerance of common end points
+    const double backX = from._x - STEP_EXTENSION * (to._x - from._x);
+    const double backY = from._y - STEP_EXTENSION * (to._y - from._y);
+    const double xMin  = std::min({from._x, to._x, backX}) - J_EPS;
+    const double yMin  = std::min({from._y, to._y, backY}) - J_EPS;
+    const double xMax  = std::max({from._x, to._x, backX}) + J_EPS;
+    const double yMax  = std::max({from._y, to._y, backY}) + J_EPS;
+
+    Line step{from, to, 0};
+    // TODO check for closed doors and distance?
+    auto passedTrans = std::find_if(
+        std::begin(transitions),
+        std::end(transitions),
+        [&](const SimulationHelper::RoomTransition & trans) -> bool {
+            if(trans.xMin > xMax || trans.xMax < xMin || trans.yMin > yMax || trans.yMax < yMin) {
+                return false;
+            }
+            return trans.transition->IntersectionWith(step) == 1;
+        });
+
+    if(passedTrans == transitions.end() || passedTrans->transition->IsInLineSegment(to)) {
+        return std::nullopt;
+    } else {
+        return passedTrans->transition;
+    }
+}
+
+/// room whose transitions ped may have passed in the last step
+int PassedRoomID(const Pedestrian & ped)
+{
+    return (ped.GetRoomID() != -1) ? ped.GetRoomID() : ped.GetOldRoomID();
+}
+
+/// FindPassedTransition() with the transitions of the room of ped, no exception is thrown in the
+/// parallel loops if the room does not exist
+std::optional<Transition *> FindPassedTransition(
+    const std::map<int, std::vector<SimulationHelper::RoomTransition>> & transitions,
+    const Pedestrian & ped)
+{
+    const auto room = transitions.find(PassedRoomID(ped));
+    if(room == std::end(transitions)) {
+        return std::nullopt;
+    }
+    return FindPassedTransition(room->second, ped);
+}
+} // namespace
 
 PedRelocation
 SimulationHelper::UpdatePedestrianRoomInformation(const Building & building, Pedestrian & ped)
 {
     // No relocation needed, ped is in its assigned room/subroom
     // TODO add check if room/subroom really exist
-    auto oldSubRoom = building.GetRoom(ped.GetRoomID())->GetSubRoom(ped.GetSubRoomID());
+    auto oldSubRoom = ped.GetSubRoom();
+    if(oldSubRoom == nullptr) {
+        // pedestrian not linked to the building yet
+        oldSubRoom = building.GetRoom(ped.GetRoomID())->GetSubRoom(ped.GetSubRoomID());
+    }
     if(oldSubRoom->IsInSubRoom(&ped)) {
         return PedRelocation::NOT_NEEDED;
     }
@@ -67,7 +154,7 @@ std::vector<Pedestrian *> SimulationHelper::FindPedestriansReachedFinalGoal(
         std::begin(peds),
         std::end(peds),
         std::inserter(pedsAtFinalGoal, std::end(pedsAtFinalGoal)),
-        [goals](const Pedestrian * ped) -> bool {
+        [&goals](const Pedestrian * ped) -> bool {
             return ped->GetFinalDestination() != FINAL_DEST_OUT &&
                    goals.at(ped->GetFinalDestination())->Contains(ped->GetPos()) &&
                    goals.at(ped->GetFinalDestination())->GetIsFinalGoal();
@@ -83,13 +170,21 @@ SimulationHelper::UpdatePedestriansLocations(
     std::vector<Pedestrian *> pedsNotRelocated;
     std::vector<Pedestrian *> pedsChangedRoom;
 
+    // every pedestrian only updates its own room information, the results are collected in the
+    // order of peds afterwards
+    std::vector<PedRelocation> relocations(peds.size());
+    const auto size = static_cast<std::ptrdiff_t>(peds.size());
+#pragma omp parallel for schedule(static)
+    for(std::ptrdiff_t i = 0; i < size; ++i) {
+        relocations[i] = UpdatePedestrianRoomInformation(building, *peds[i]);
+    }
+
     // Check for peds, where relocation failed
-    for(auto const ped : peds) {
-        auto relocated = UpdatePedestrianRoomInformation(building, *ped);
-        if(relocated == PedRelocation::SUCCESSFUL && ped->ChangedRoom()) {
-            pedsChangedRoom.push_back(ped);
-        } else if(relocated == PedRelocation::FAILED) {
-            pedsNotRelocated.push_back(ped);
+    for(std::size_t i = 0; i < peds.size(); ++i) {
+        if(relocations[i] == PedRelocation::SUCCESSFUL && peds[i]->ChangedRoom()) {
+            pedsChangedRoom.push_back(peds[i]);
+        } else if(relocations[i] == PedRelocation::FAILED) {
+            pedsNotRelocated.push_back(peds[i]);
         }
     }
 
@@ -104,23 +199,32 @@ std::vector<Pedestrian *> SimulationHelper::FindPedestriansOutside(
     std::vector<Pedestrian *> newPeds;
     double maxDistance = 0.5;
 
-    std::partition_copy(
-        std::begin(peds),
-        std::end(peds),
-        std::back_inserter(pedsOutside),
-        std::back_inserter(newPeds),
-        [&building, maxDistance](const Pedestrian * ped) -> bool {
-            auto transPassed = SimulationHelper::FindPassedDoor(building, *ped);
-            if(!transPassed.has_value()) {
-                return false;
-            }
+    const auto transitions = CollectRoomTransitions(building);
+    std::vector<char> outside(peds.size());
+    const auto size = static_cast<std::ptrdiff_t>(peds.size());
+#pragma omp parallel for schedule(static)
+    for(std::ptrdiff_t i = 0; i < size; ++i) {
+        const Pedestrian * ped = peds[i];
+        auto transPassed       = FindPassedTransition(transitions, *ped);
+        if(!transPassed.has_value()) {
+            outside[i] = false;
+            continue;
+        }
 
-            //TODO maxDistance should depend on vmax
-            bool passedExit     = transPassed.value()->IsExit();
-            bool passedOpenDoor = transPassed.value()->IsOpen();
-            bool doorIsClose    = transPassed.value()->DistTo(ped->GetPos()) < maxDistance;
-            return passedExit && passedOpenDoor && doorIsClose;
-        });
+        //TODO maxDistance should depend on vmax
+        bool passedExit     = transPassed.value()->IsExit();
+        bool passedOpenDoor = transPassed.value()->IsOpen();
+        bool doorIsClose    = transPassed.value()->DistTo(ped->GetPos()) < maxDistance;
+        outside[i]          = passedExit && passedOpenDoor && doorIsClose;
+    }
+
+    for(std::size_t i = 0; i < peds.size(); ++i) {
+        if(outside[i]) {
+            pedsOutside.push_back(peds[i]);
+        } else {
+            newPeds.push_back(peds[i]);
+        }
+    }
     peds = std::move(newPeds);
     return pedsOutside;
 }
@@ -129,8 +233,20 @@ void SimulationHelper::UpdateFlowAtDoors(
     Building & building,
     const std::vector<Pedestrian *> & pedsChangedRoom)
 {
-    for(const auto ped : pedsChangedRoom) {
-        auto closestTransition = SimulationHelper::FindPassedDoor(building, *ped);
+    // the passed doors are searched in parallel, the door usage is counted in the order of
+    // pedsChangedRoom
+    const auto transitions = CollectRoomTransitions(building);
+    std::vector<std::optional<Transition *>> passedDoors(pedsChangedRoom.size());
+    const auto size = static_cast<std::ptrdiff_t>(pedsChangedRoom.size());
+#pragma omp parallel for schedule(static)
+    for(std::ptrdiff_t i = 0; i < size; ++i) {
+        const Pedestrian * ped = pedsChangedRoom[i];
+        passedDoors[i]         = FindPassedTransition(transitions, *ped);
+    }
+
+    for(std::size_t i = 0; i < pedsChangedRoom.size(); ++i) {
+        const auto ped         = pedsChangedRoom[i];
+        auto closestTransition = passedDoors[i];
 
         if(!closestTransition.has_value()) {
             LOG_WARNING("Ped {} did not cross any transition", ped->GetID());
@@ -154,34 +270,38 @@ void SimulationHelper::UpdateFlowAtDoors(
     }
 }
 
+std::map<int, std::vector<SimulationHelper::RoomTransition>>
+SimulationHelper::CollectRoomTransitions(const Building & building)
+{
+    std::map<int, std::vector<RoomTransition>> transitions;
+    for(auto const & [roomID, room] : building.GetAllRooms()) {
+        transitions.emplace(roomID, CollectTransitions(*room));
+    }
+    return transitions;
+}
+
 std::optional<Transition *>
 SimulationHelper::FindPassedDoor(const Building & building, const Pedestrian & ped)
 {
-    std::vector<Transition *> transitions;
-
     // TODO check if room exists?
-    auto room = (ped.GetRoomID() != -1) ? (building.GetAllRooms().at(ped.GetRoomID())) :
-                                          (building.GetAllRooms().at(ped.GetOldRoomID()));
-
-    for(auto const & [subroomID, subroom] : room->GetAllSubRooms()) {
-        transitions.insert(
-            std::end(transitions),
-            std::begin(subroom->GetAllTransitions()),
-            std::end(subroom->GetAllTransitions()));
-    }
-
-    Line step{ped.GetLastPosition(), ped.GetPos(), 0};
-    // TODO check for closed doors and distance?
-    auto passedTrans = std::find_if(
-        std::begin(transitions), std::end(transitions), [&step](const Transition * trans) -> bool {
-            return trans->IntersectionWith(step) == 1;
-        });
+    const auto & room = building.GetAllRooms().at(PassedRoomID(ped));
+    return FindPassedTransition(CollectTransitions(*room), ped);
+}
 
-    if(passedTrans == transitions.end() || (*passedTrans)->IsInLineSegment(ped.GetPos())) {
-        return std::nullopt;
-    } else {
-        return *passedTrans;
+std::vector<std::optional<int>>
+SimulationHelper::FindReentrantRoutes(const std::vector<Pedestrian *> & peds)
+{
+    // reentrant routers only write to the pedestrian they are asked for, so their routes do not
+    // depend on the order of the pedestrians and are found in parallel
+    std::vector<std::optional<int>> targets(peds.size());
+#pragma omp parallel for schedule(dynamic, 16)
+    for(std::size_t i = 0; i < peds.size(); ++i) {
+        const Router * router = peds[i]->GetRouter();
+        if(router != nullptr && router->IsReentrant()) {
+            targets[i] = peds[i]->FindRoute();
+        }
     }
+    return targets;
 }
 
 bool SimulationHelper::UpdateFlowRegulation(Building & building)
@@ -273,9 +393,5 @@ void SimulationHelper::RemovePedestrians(Building & building, std::vector<Pedest
     sort(peds.begin(), peds.end());
     peds.erase(unique(peds.begin(), peds.end()), peds.end());
 
-    std::for_each(std::begin(peds), std::end(peds), [&building](Pedestrian * ped) {
-        building.DeletePedestrian(ped);
-    });
-
-    peds.clear();
+    building.DeletePedestrians(peds);
 }
@@ -22,6 +22,7 @@
 #include "geometry/Building.h"
 #include "pedestrian/Pedestrian.h"
 
+#include <map>
 #include <optional>
 #include <vector>
 
@@ -29,6 +30,18 @@ enum class PedRelocation { SUCCESSFUL, NOT_NEEDED, FAILED };
 
 namespace SimulationHelper
 {
+/**
+ * Transition of a room together with its bounding box, the box allows FindPassedDoor() to skip
+ * the intersection test for most transitions.
+ */
+struct RoomTransition {
+    Transition * transition;
+    double xMin;
+    double yMin;
+    double xMax;
+    double yMax;
+};
+
 /**
  * Checks whether the pedestrian \p ped is still in the assigned room. If not check if \p ped is
  * in an neighbouring room/subroom and update the information. If \p ped has moved to a
@@ -85,6 +98,15 @@ UpdatePedestriansLocations(const Building & building, const std::vector<Pedestri
  */
 void UpdateFlowAtDoors(Building & building, const std::vector<Pedestrian *> & pedsChangedRoom);
 
+/**
+ * Finds the routes of the pedestrians whose router is reentrant, see Router::IsReentrant(), in
+ * parallel. Each route only depends on its pedestrian, not on the number of threads.
+ * @param peds list of pedestrians
+ * @return the target of each pedestrian in \p peds, nullopt if its router is not reentrant and
+ * the route has to be found serially
+ */
+std::vector<std::optional<int>> FindReentrantRoutes(const std::vector<Pedestrian *> & peds);
+
 /**
  * Triggers the flow regulation, and closes/opens doors accordingly
  * @param building geometry used in the simulation
@@ -109,6 +131,14 @@ bool UpdateTrainFlowRegulation(Building & building);
  */
 std::optional<Transition *> FindPassedDoor(const Building & building, const Pedestrian & ped);
 
+/**
+ * Collects the transitions of all subrooms of each room, in the order FindPassedDoor() tests
+ * them. FindPedestriansOutside() and UpdateFlowAtDoors() collect them once for all pedestrians.
+ * @param building geometry used in the simulation
+ * @return the transitions of each room by room ID
+ */
+std::map<int, std::vector<RoomTransition>> CollectRoomTransitions(const Building & building);
+
 /**
  * Removes the pedestrians \p pedsFaulty from the simulation, e.g., the building. Additionally
  * prints an error message to the log, containing the pedestrians ID and a \p message.
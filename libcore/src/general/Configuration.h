@@ -54,6 +54,10 @@ public:
         _tMax             = 500;     // seconds
         _dT               = 0.01;
         _isPeriodic       = 0; // use only for Tordeux2015 with "trivial" geometries
+        // ----------- linked cells ------
+        _verletSkin        = 0; // meter, Verlet lists disabled
+        _agentSortInterval = 0; // time steps, spatial sorting disabled
+        _elevationBand     = 0; // meter, 2D grid
         // ----------- GCFM repulsive force ------
         _nuPed  = 0.4;
         _nuWall = 0.2;
@@ -76,6 +80,14 @@ public:
         // -------- Interpolation GCFM - right side
         _distEffMaxPed  = 2;
         _distEffMaxWall = 2;
+        // -------- Cutoff of the repulsive wall forces
+        _wallCutoff = 0; // all walls act on every agent
+        // -------- GCFM evaluates the geometry of each pair of agents once
+        _pairwiseForcePed = false;
+        // -------- GCFM integrates the agents in contact with sub-steps
+        _maxSubSteps = 1;
+        // -------- Velocity model approximates the exponential repulsion
+        _fastMath = false;
         // ----------------
 
         _hostname                 = "localhost";
@@ -86,6 +98,7 @@ public:
         _geometryFile             = "";
         _projectRootDir           = ".";
         _showStatistics           = false;
+        _stableAgentOrder         = false;
         _fileFormat               = FileFormat::TXT;
         _agentsParameters         = std::map<int, std::shared_ptr<AgentsParameters>>();
         // ---------- floorfield
@@ -142,6 +155,18 @@ public:
 
     void SetLinkedCellSize(double linkedCellSize) { _linkedCellSize = linkedCellSize; };
 
+    double GetVerletSkin() const { return _verletSkin; };
+
+    void SetVerletSkin(double verletSkin) { _verletSkin = verletSkin; };
+
+    int GetAgentSortInterval() const { return _agentSortInterval; };
+
+    void SetAgentSortInterval(int agentSortInterval) { _agentSortInterval = agentSortInterval; };
+
+    double GetElevationBand() const { return _elevationBand; };
+
+    void SetElevationBand(double elevationBand) { _elevationBand = elevationBand; };
+
     std::shared_ptr<OperationalModel> GetModel() const { return _model; };
 
     void SetModel(std::shared_ptr<OperationalModel> model) { _model = model; };
@@ -222,6 +247,22 @@ public:
 
     void SetDistEffMaxWall(double distEffMaxWall) { _distEffMaxWall = distEffMaxWall; };
 
+    double GetWallCutoff() const { return _wallCutoff; };
+
+    void SetWallCutoff(double wallCutoff) { _wallCutoff = wallCutoff; };
+
+    bool GetPairwiseForcePed() const { return _pairwiseForcePed; };
+
+    void SetPairwiseForcePed(bool pairwise) { _pairwiseForcePed = pairwise; };
+
+    int GetMaxSubSteps() const { return _maxSubSteps; };
+
+    void SetMaxSubSteps(int maxSubSteps) { _maxSubSteps = maxSubSteps; };
+
+    bool GetFastMath() const { return _fastMath; };
+
+    void SetFastMath(bool fastMath) { _fastMath = fastMath; };
+
     double get_deltaH() const { return _deltaH; }
 
     void set_deltaH(double deltaH) { _deltaH = deltaH; }
@@ -368,6 +409,10 @@ public:
 
     void SetShowStatistics(bool showStatistics) { _showStatistics = showStatistics; };
 
+    bool GetStableAgentOrder() const { return _stableAgentOrder; };
+
+    void SetStableAgentOrder(bool stableAgentOrder) { _stableAgentOrder = stableAgentOrder; };
+
     const FileFormat & GetFileFormat() const { return _fileFormat; };
 
     void SetFileFormat(FileFormat fileFormat) { _fileFormat = fileFormat; };
@@ -397,6 +442,9 @@ private:
     double _fps;
     unsigned int _precision;
     double _linkedCellSize;
+    double _verletSkin;
+    int _agentSortInterval;
+    double _elevationBand;
     std::shared_ptr<OperationalModel> _model;
     double _tMax;
     double _dT;
@@ -417,6 +465,10 @@ private:
     double _maxFWall;
     double _distEffMaxPed;
     double _distEffMaxWall;
+    double _wallCutoff;
+    bool _pairwiseForcePed;
+    int _maxSubSteps;
+    bool _fastMath;
     // floorfield
     double _deltaH;
     double _wall_avoid_distance;
@@ -454,6 +506,8 @@ private:
     fs::path _projectRootDir;
     fs::path _outputPath;
     bool _showStatistics;
+    /// keep the insertion order of the agents when removing agents (slower, reproducible)
+    bool _stableAgentOrder;
 
     mutable RandomNumberGenerator _rdGenerator;
 
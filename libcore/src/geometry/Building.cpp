@@ -56,9 +56,11 @@
 #include <boost/algorithm/string/detail/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <cfloat>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <string>
@@ -78,7 +80,8 @@ Building::Building()
 Building::Building(Configuration * configuration, PedDistributor & pedDistributor) :
     _configuration(configuration),
     _routingEngine(configuration->GetRoutingEngine()),
-    _caption("no_caption")
+    _caption("no_caption"),
+    _stableAgentOrder(configuration->GetStableAgentOrder())
 {
     _savePathway = false;
 
@@ -123,6 +126,9 @@ Building::~Building()
         delete pedestrian;
     }
     _allPedestrians.clear();
+    _pedestrianIndex.clear();
+    _subroomPedestrians.clear();
+    _subroomSlots.clear();
 #endif
 
     if(_pathWayStream.is_open())
@@ -161,6 +167,11 @@ Configuration * Building::GetConfig() const
     return _configuration;
 }
 
+void Building::SetConfig(Configuration * config)
+{
+    _configuration = config;
+}
+
 void Building::SetCaption(const std::string & s)
 {
     _caption = s;
@@ -208,9 +219,26 @@ const NeighborhoodSearch & Building::GetNeighborhoodSearch() const
     return _neighborhoodSearch;
 }
 
+const AgentsKinematics & Building::GetKinematics() const
+{
+    return _kinematics;
+}
+
+AgentsKinematics & Building::GetKinematics()
+{
+    return _kinematics;
+}
+
 void Building::AddRoom(Room * room)
 {
     _rooms[room->GetID()] = std::shared_ptr<Room>(room);
+    for(auto && itr_subroom : room->GetAllSubRooms()) {
+        _subRoomsByUID[itr_subroom.second->GetUID()] = itr_subroom.second.get();
+    }
+    // a replaced room invalidates the rooms and subrooms cached by the pedestrians
+    for(auto ped : _allPedestrians) {
+        ped->UpdateRoomPointers();
+    }
 }
 
 void Building::AddSurroundingRoom()
@@ -321,6 +349,10 @@ bool Building::InitGeometry()
             //here we can create a boost::geometry::model::polygon out of the vector<Point> objects created above
             itr_subroom.second->CreateBoostPoly();
 
+            // speeds up the visibility checks and the location of the pedestrians
+            itr_subroom.second->UpdateWallGrid();
+            itr_subroom.second->UpdateLocationRaster();
+
             double minElevation = FLT_MAX;
             double maxElevation = -FLT_MAX;
             for(auto && wall : itr_subroom.second->GetAllWalls()) {
@@ -470,13 +502,16 @@ bool Building::AddCrossing(Crossing * line)
         LOG_ERROR("Duplicate index for crossing found [{}] in Routing::AddCrossing()", IDCrossing);
         exit(EXIT_FAILURE);
     }
-    _crossings[IDCrossing] = line;
+    _crossings[IDCrossing]               = line;
+    _crossingsByUID[line->GetUniqueID()] = line;
     return true;
 }
 
 bool Building::RemoveTransition(Transition * line)
 {
     if(_transitions.count(line->GetID()) != 0) {
+        // line may be a copy of the stored transition
+        _transitionsByUID.erase(_transitions.at(line->GetID())->GetUniqueID());
         _transitions.erase(line->GetID());
         return true;
     }
@@ -490,7 +525,8 @@ bool Building::AddTransition(Transition * line)
             "Duplicate index for transition found [{}] in Routing::AddTransition()", line->GetID());
         exit(EXIT_FAILURE);
     }
-    _transitions[line->GetID()] = line;
+    _transitions[line->GetID()]            = line;
+    _transitionsByUID[line->GetUniqueID()] = line;
 
     return true;
 }
@@ -512,7 +548,8 @@ bool Building::AddHline(Hline * line)
             exit(EXIT_FAILURE);
         }
     }
-    _hLines[line->GetID()] = line;
+    _hLines[line->GetID()]            = line;
+    _hLinesByUID[line->GetUniqueID()] = line;
     return true;
 }
 
@@ -640,28 +677,17 @@ Crossing * Building::GetTransOrCrossByName(std::string caption) const
 
 Hline * Building::GetTransOrCrossByUID(int id) const
 {
-    {
-        //eventually transitions
-        std::map<int, Transition *>::const_iterator itr;
-        for(itr = _transitions.begin(); itr != _transitions.end(); ++itr) {
-            if(itr->second->GetUniqueID() == id)
-                return itr->second;
-        }
+    //eventually transitions
+    if(auto itr = _transitionsByUID.find(id); itr != _transitionsByUID.end()) {
+        return itr->second;
     }
-    {
-        //then the  crossings
-        std::map<int, Crossing *>::const_iterator itr;
-        for(itr = _crossings.begin(); itr != _crossings.end(); ++itr) {
-            if(itr->second->GetUniqueID() == id)
-                return itr->second;
-        }
+    //then the  crossings
+    if(auto itr = _crossingsByUID.find(id); itr != _crossingsByUID.end()) {
+        return itr->second;
     }
-    {
-        //finally the  hlines
-        for(auto itr = _hLines.begin(); itr != _hLines.end(); ++itr) {
-            if(itr->second->GetUniqueID() == id)
-                return itr->second;
-        }
+    //finally the  hlines
+    if(auto itr = _hLinesByUID.find(id); itr != _hLinesByUID.end()) {
+        return itr->second;
     }
     LOG_ERROR("No Transition, Crossing or hline with ID {} found.", id);
     return nullptr;
@@ -669,6 +695,10 @@ Hline * Building::GetTransOrCrossByUID(int id) const
 
 SubRoom * Building::GetSubRoomByUID(int uid) const
 {
+    if(auto itr = _subRoomsByUID.find(uid); itr != _subRoomsByUID.end()) {
+        return itr->second;
+    }
+    // subrooms added to a room after Building::AddRoom() are not indexed
     for(auto && itr_room : _rooms) {
         for(auto && itr_subroom : itr_room.second->GetAllSubRooms()) {
             if(itr_subroom.second->GetUID() == uid)
@@ -703,6 +733,15 @@ bool Building::IsVisible(
     return true;
 }
 
+bool Building::IsVisible(const Point & p1, const Point & p2, SubRoom * sub1, SubRoom * sub2)
+    const
+{
+    if(sub1 && !sub1->IsVisible(p1, p2)) {
+        return false;
+    }
+    return sub2 == sub1 || !sub2 || sub2->IsVisible(p1, p2);
+}
+
 bool Building::Triangulate()
 {
     LOG_INFO("Triangulating the geometry.");
@@ -762,7 +801,27 @@ bool Building::SanityCheck()
 
 void Building::UpdateGrid()
 {
+    _kinematics.Gather(_allPedestrians);
     _neighborhoodSearch.Update(_allPedestrians);
+
+    // keep the buckets to avoid reallocations
+    for(auto & bucket : _subroomPedestrians) {
+        bucket.second.clear();
+    }
+    _subroomSlots.clear();
+    for(auto * ped : _allPedestrians) {
+        AddToSubRoomIndex(ped);
+    }
+}
+
+void Building::InitWallDistanceFields(double cutoff)
+{
+    for(auto && itr_room : _rooms) {
+        for(auto && itr_subroom : itr_room.second->GetAllSubRooms()) {
+            itr_subroom.second->UpdateWallDistanceField(cutoff);
+        }
+    }
+    LOG_INFO("Initialized the wall distance fields with cutoff {:.2f}", cutoff);
 }
 
 void Building::InitGrid()
@@ -819,39 +878,135 @@ void Building::InitGrid()
     }
 
     _neighborhoodSearch = NeighborhoodSearch(x_min, x_max, y_min, y_max, cellSize);
+    _neighborhoodSearch.SetVerletSkin(_configuration->GetVerletSkin());
+
+    // separate the floors by their elevation
+    if(_configuration->GetElevationBand() > 0) {
+        double z_min = FLT_MAX;
+        double z_max = -FLT_MAX;
+        for(auto && itr_room : _rooms) {
+            for(auto && itr_subroom : itr_room.second->GetAllSubRooms()) {
+                z_min = std::min(z_min, itr_subroom.second->GetMinElevation());
+                z_max = std::max(z_max, itr_subroom.second->GetMaxElevation());
+            }
+        }
+        _neighborhoodSearch.SetElevationBands(z_min, z_max, _configuration->GetElevationBand());
+        LOG_INFO(
+            "Elevation bands of {:.2f} m between {:.2f} m and {:.2f} m",
+            _configuration->GetElevationBand(),
+            z_min,
+            z_max);
+    }
 
     LOG_INFO("Done with Initializing the grid");
 }
 
 void Building::DeletePedestrian(Pedestrian *& ped)
 {
-    std::vector<Pedestrian *>::iterator it;
-    it = find(_allPedestrians.begin(), _allPedestrians.end(), ped);
-    if(it == _allPedestrians.end()) {
+    auto index = _pedestrianIndex.find(ped->GetID());
+    if(index == _pedestrianIndex.end() || _allPedestrians[index->second] != ped) {
         LOG_ERROR("Pedestrian with ID {} not found.", ped->GetID());
         return;
+    }
+    // save the path history for this pedestrian before removing from the simulation
+    SavePedestrianPathway(*ped);
+
+    const std::size_t position = index->second;
+    _pedestrianIndex.erase(index);
+    RemoveFromSubRoomIndex(*ped);
+    if(_stableAgentOrder) {
+        _allPedestrians.erase(_allPedestrians.begin() + position);
+        UpdatePedestrianIndex(position);
     } else {
-        // save the path history for this pedestrian before removing from the simulation
-        if(_savePathway) {
-            // string results;
-            std::string path = (*it)->GetPath();
-            std::vector<std::string> brokenpaths;
-            StringExplode(path, ">", &brokenpaths);
-            for(unsigned int i = 0; i < brokenpaths.size(); i++) {
-                std::vector<std::string> tags;
-                StringExplode(brokenpaths[i], ":", &tags);
-                std::string room  = _rooms[atoi(tags[0].c_str())]->GetCaption();
-                std::string trans = GetTransition(atoi(tags[1].c_str()))->GetCaption();
-                //ignore crossings/hlines
-                if(trans != "")
-                    _pathWayStream << room << " " << trans << std::endl;
-            }
+        // swap and pop, only the former last pedestrian changes its position
+        _allPedestrians[position] = _allPedestrians.back();
+        _allPedestrians.pop_back();
+        if(position < _allPedestrians.size()) {
+            _pedestrianIndex[_allPedestrians[position]->GetID()] = position;
         }
     }
-    _allPedestrians.erase(it);
     delete ped;
 }
 
+void Building::DeletePedestrians(std::vector<Pedestrian *> & peds)
+{
+    std::sort(std::begin(peds), std::end(peds), [](const Pedestrian * a, const Pedestrian * b) {
+        return a->GetID() < b->GetID();
+    });
+
+    if(!_stableAgentOrder) {
+        for(auto ped : peds) {
+            DeletePedestrian(ped);
+        }
+        peds.clear();
+        return;
+    }
+
+    // mark the deleted pedestrians and compact _allPedestrians once
+    std::size_t first = _allPedestrians.size();
+    for(auto ped : peds) {
+        auto index = _pedestrianIndex.find(ped->GetID());
+        if(index == _pedestrianIndex.end() || _allPedestrians[index->second] != ped) {
+            LOG_ERROR("Pedestrian with ID {} not found.", ped->GetID());
+            continue;
+        }
+        SavePedestrianPathway(*ped);
+        first                          = std::min(first, index->second);
+        _allPedestrians[index->second] = nullptr;
+        _pedestrianIndex.erase(index);
+        RemoveFromSubRoomIndex(*ped);
+        delete ped;
+    }
+    _allPedestrians.erase(
+        std::remove(std::begin(_allPedestrians) + first, std::end(_allPedestrians), nullptr),
+        std::end(_allPedestrians));
+    UpdatePedestrianIndex(first);
+    peds.clear();
+}
+
+void Building::SavePedestrianPathway(Pedestrian & ped)
+{
+    if(!_savePathway) {
+        return;
+    }
+    std::string path = ped.GetPath();
+    std::vector<std::string> brokenpaths;
+    StringExplode(path, ">", &brokenpaths);
+    for(unsigned int i = 0; i < brokenpaths.size(); i++) {
+        std::vector<std::string> tags;
+        StringExplode(brokenpaths[i], ":", &tags);
+        std::string room  = _rooms[atoi(tags[0].c_str())]->GetCaption();
+        std::string trans = GetTransition(atoi(tags[1].c_str()))->GetCaption();
+        //ignore crossings/hlines
+        if(trans != "")
+            _pathWayStream << room << " " << trans << std::endl;
+    }
+}
+
+void Building::UpdatePedestrianIndex(std::size_t first)
+{
+    for(std::size_t position = first; position < _allPedestrians.size(); ++position) {
+        _pedestrianIndex[_allPedestrians[position]->GetID()] = position;
+    }
+}
+
+void Building::SortPedestriansSpatially()
+{
+    std::vector<std::pair<std::uint64_t, Pedestrian *>> keys;
+    keys.reserve(_allPedestrians.size());
+    for(auto ped : _allPedestrians) {
+        keys.emplace_back(_neighborhoodSearch.GetMortonKey(ped->GetPos()), ped);
+    }
+    // the ID makes the order independent of the previous order
+    std::sort(std::begin(keys), std::end(keys), [](const auto & a, const auto & b) {
+        return a.first < b.first || (a.first == b.first && a.second->GetID() < b.second->GetID());
+    });
+    for(std::size_t position = 0; position < keys.size(); ++position) {
+        _allPedestrians[position] = keys[position].second;
+    }
+    UpdatePedestrianIndex(0);
+}
+
 const std::vector<Pedestrian *> & Building::GetAllPedestrians() const
 {
     return _allPedestrians;
@@ -859,22 +1014,43 @@ const std::vector<Pedestrian *> & Building::GetAllPedestrians() const
 
 void Building::AddPedestrian(Pedestrian * ped)
 {
-    if(std::find_if(
-           std::begin(_allPedestrians), std::end(_allPedestrians), [ped](const Pedestrian * other) {
-               return ped->GetID() == other->GetID();
-           }) != std::end(_allPedestrians)) {
+    if(_pedestrianIndex.count(ped->GetID()) != 0) {
         LOG_WARNING("Pedestrian {} already in the room.", ped->GetID());
     } else {
+        _pedestrianIndex[ped->GetID()] = _allPedestrians.size();
         _allPedestrians.push_back(ped);
+        AddToSubRoomIndex(ped);
     }
 }
 
 void Building::GetPedestrians(int room, int subroom, std::vector<Pedestrian *> & peds) const
 {
-    for(auto && ped : _allPedestrians) {
-        if((room == ped->GetRoomID()) && (subroom == ped->GetSubRoomID())) {
-            peds.push_back(ped);
-        }
+    // same key as Pedestrian::GetUniqueRoomID()
+    auto bucket = _subroomPedestrians.find(room * 1000 + subroom);
+    if(bucket != _subroomPedestrians.end()) {
+        // skip the deleted pedestrians
+        std::copy_if(
+            std::begin(bucket->second),
+            std::end(bucket->second),
+            std::back_inserter(peds),
+            [](const Pedestrian * ped) { return ped != nullptr; });
+    }
+}
+
+void Building::AddToSubRoomIndex(Pedestrian * ped)
+{
+    auto & bucket               = _subroomPedestrians[ped->GetUniqueRoomID()];
+    _subroomSlots[ped->GetID()] = {ped->GetUniqueRoomID(), bucket.size()};
+    bucket.push_back(ped);
+}
+
+void Building::RemoveFromSubRoomIndex(const Pedestrian & ped)
+{
+    // the slot is still valid if the pedestrian changed the subroom since the last UpdateGrid()
+    auto slot = _subroomSlots.find(ped.GetID());
+    if(slot != _subroomSlots.end()) {
+        _subroomPedestrians[slot->second.first][slot->second.second] = nullptr;
+        _subroomSlots.erase(slot);
     }
 }
 
@@ -916,32 +1092,23 @@ void Building::StringExplode(
 
 Pedestrian * Building::GetPedestrian(int pedID) const
 {
-    for(unsigned int p = 0; p < _allPedestrians.size(); p++) {
-        Pedestrian * ped = _allPedestrians[p];
-        if(ped->GetID() == pedID) {
-            return ped;
-        }
+    auto index = _pedestrianIndex.find(pedID);
+    if(index == _pedestrianIndex.end()) {
+        return nullptr;
     }
-
-    return nullptr;
+    return _allPedestrians[index->second];
 }
 
 Transition * Building::GetTransitionByUID(int uid) const
 {
-    for(auto && trans : _transitions) {
-        if(trans.second->GetUniqueID() == uid)
-            return trans.second;
-    }
-    return nullptr;
+    auto itr = _transitionsByUID.find(uid);
+    return itr != _transitionsByUID.end() ? itr->second : nullptr;
 }
 
 Crossing * Building::GetCrossingByUID(int uid) const
 {
-    for(auto && cross : _crossings) {
-        if(cross.second->GetUniqueID() == uid)
-            return cross.second;
-    }
-    return nullptr;
+    auto itr = _crossingsByUID.find(uid);
+    return itr != _crossingsByUID.end() ? itr->second : nullptr;
 }
 
 bool Building::SaveGeometry(const fs::path & filename) const
@@ -37,8 +37,12 @@
 #include "general/Configuration.h"
 #include "general/Filesystem.h"
 #include "neighborhood/NeighborhoodSearch.h"
+#include "pedestrian/AgentsKinematics.h"
 
+#include <cstddef>
 #include <optional>
+#include <unordered_map>
+#include <utility>
 
 using PointWall = std::pair<Point, Wall>;
 
@@ -63,11 +67,28 @@ private:
     std::string _geometryFilename;
     NeighborhoodSearch _neighborhoodSearch;
     std::vector<Pedestrian *> _allPedestrians;
+    /// position of each pedestrian in _allPedestrians, indexed by the pedestrian ID
+    std::unordered_map<int, std::size_t> _pedestrianIndex;
+    /// keep the insertion order of _allPedestrians when pedestrians are deleted
+    bool _stableAgentOrder = false;
+    /// kinematic state of _allPedestrians, refreshed by UpdateGrid()
+    AgentsKinematics _kinematics;
+    /// pedestrians of each subroom indexed by the unique room ID, refreshed by UpdateGrid()
+    std::unordered_map<int, std::vector<Pedestrian *>> _subroomPedestrians;
+    /// bucket in _subroomPedestrians and position in it of each pedestrian, indexed by the ID.
+    /// Deleted pedestrians leave a nullptr in their bucket until the next UpdateGrid()
+    std::unordered_map<int, std::pair<int, std::size_t>> _subroomSlots;
     std::map<int, std::shared_ptr<Room>> _rooms;
     std::map<int, Crossing *> _crossings;
     std::map<int, Transition *> _transitions;
     std::map<int, Hline *> _hLines;
     std::map<int, Goal *> _goals;
+    /// _transitions, _crossings and _hLines indexed by their unique id
+    std::unordered_map<int, Transition *> _transitionsByUID;
+    std::unordered_map<int, Crossing *> _crossingsByUID;
+    std::unordered_map<int, Hline *> _hLinesByUID;
+    /// subrooms of _rooms indexed by their unique id, refreshed by AddRoom()
+    std::unordered_map<int, SubRoom *> _subRoomsByUID;
     /// pedestrians pathway
     bool _savePathway;
     std::ofstream _pathWayStream;
@@ -102,14 +123,57 @@ public:
 
     Configuration * GetConfig() const;
 
+    /**
+     * Sets the configuration of a building that was not loaded from a project file.
+     * @param config configuration, owned by the caller
+     */
+    void SetConfig(Configuration * config);
+
     void SetCaption(const std::string & s);
 
-    /// delete the ped from the ped vector
+    /**
+     * Deletes the ped from the simulation. By default the ped is replaced by the last pedestrian
+     * in GetAllPedestrians(), which changes the order of the pedestrians. If the stable agent order
+     * is requested the remaining pedestrians keep their order.
+     * @param ped pedestrian to delete
+     */
     void DeletePedestrian(Pedestrian *& ped);
 
+    /**
+     * Deletes all \p peds from the simulation and clears \p peds. The pedestrians are deleted in
+     * the order of their IDs, so the resulting order of GetAllPedestrians() does not depend on the
+     * order of \p peds. With the stable agent order the remaining pedestrians are compacted in a
+     * single pass.
+     * @param peds pedestrians to delete, must not contain duplicates
+     */
+    void DeletePedestrians(std::vector<Pedestrian *> & peds);
+
+    /**
+     * Sorts the pedestrians along the Morton curve of the linked cells, so pedestrians close to
+     * each other are close in GetAllPedestrians() and in the kinematics store. UpdateGrid() has to
+     * be called afterwards.
+     */
+    void SortPedestriansSpatially();
+
+    /**
+     * Defines whether the pedestrians keep their insertion order when pedestrians are deleted.
+     * @param stableAgentOrder true to keep the order
+     */
+    void SetStableAgentOrder(bool stableAgentOrder) { _stableAgentOrder = stableAgentOrder; }
+
     /// delete the ped from the simulation
     void AddPedestrian(Pedestrian * ped);
 
+    /**
+     * Appends all pedestrians in the subroom to peds. The subrooms are assigned by UpdateGrid(), a
+     * pedestrian that changed its subroom since then is still found in the old one. The order is
+     * the order of GetAllPedestrians() at the last UpdateGrid() followed by the pedestrians added
+     * since then, it may differ from the current order of GetAllPedestrians(). Deleted pedestrians
+     * are not returned.
+     * @param room ID of the room
+     * @param subroom ID of the subroom
+     * @param peds pedestrians in the subroom
+     */
     void GetPedestrians(int room, int subroom, std::vector<Pedestrian *> & peds) const;
 
     std::string GetCaption() const;
@@ -170,6 +234,14 @@ public:
         const std::vector<SubRoom *> & subrooms,
         bool considerHlines = false);
 
+    /**
+      * Visibility check between two pedestrians, only the walls of their subrooms are used.
+      * Same as IsVisible(p1, p2, {sub1, sub2}) without creating a vector, sub1 is checked only
+      * once if both pedestrians are in the same subroom.
+      * @return true if the two points are visible from each other
+      */
+    bool IsVisible(const Point & p1, const Point & p2, SubRoom * sub1, SubRoom * sub2) const;
+
     /**
       * @return a crossing or a transition matching the given caption.
       * Return NULL if none is found
@@ -194,16 +266,38 @@ public:
 
     const NeighborhoodSearch & GetNeighborhoodSearch() const;
 
+    /**
+      * @return the kinematic state of all pedestrians, slot i belongs to GetAllPedestrians()[i].
+      * Valid from the last call of UpdateGrid() until pedestrians are added or removed.
+      */
+    const AgentsKinematics & GetKinematics() const;
+
+    /**
+      * @return the kinematic state of all pedestrians, slot i belongs to GetAllPedestrians()[i].
+      * Valid from the last call of UpdateGrid() until pedestrians are added or removed.
+      */
+    AgentsKinematics & GetKinematics();
+
     // convenience methods
     bool InitGeometry();
 
 
     void InitGrid();
 
+    /**
+     * Builds the wall distance fields of all subrooms, see SubRoom::UpdateWallDistanceField().
+     * @param cutoff walls farther away from an agent than cutoff (in m) do not act on it
+     */
+    void InitWallDistanceFields(double cutoff);
+
     void InitSavePedPathway(const std::string & filename);
 
     void AddRoom(Room * room);
 
+    /**
+     * Refreshes the linked cells, the kinematics store and the pedestrians of each subroom with
+     * the current state of the pedestrians.
+     */
     void UpdateGrid();
 
     void
@@ -314,4 +408,12 @@ private:
     bool InitInsideGoals();
     void InitPlatforms();
     void StringExplode(std::string str, std::string separator, std::vector<std::string> * results);
+    /// writes the path of ped to the pathway file, if requested
+    void SavePedestrianPathway(Pedestrian & ped);
+    /// refreshes _pedestrianIndex for all pedestrians starting at position first
+    void UpdatePedestrianIndex(std::size_t first);
+    /// appends ped to its bucket in _subroomPedestrians
+    void AddToSubRoomIndex(Pedestrian * ped);
+    /// removes ped from _subroomPedestrians
+    void RemoveFromSubRoomIndex(const Pedestrian & ped);
 };
@@ -0,0 +1,155 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "LocationRaster.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+/// edge of a cell in m, enlarged for very large areas
+constexpr double CELL_SIZE = 0.25;
+
+/// upper bound of the number of cells of one raster
+constexpr double MAX_CELLS = 1 << 20;
+
+/// bound of the cross product used by Line::IsInLineSegment()
+constexpr double SEGMENT_TOLERANCE = 0.0001;
+
+/// additional width of the boundary covering rounding errors of the exact test
+constexpr double ROUNDING_MARGIN = 1e-6;
+
+/// distance between the point (x, y) and segment
+double DistanceTo(const Line & segment, double x, double y)
+{
+    const Point & p1 = segment.GetPoint1();
+    const Point & p2 = segment.GetPoint2();
+    const double dx  = p2._x - p1._x;
+    const double dy  = p2._y - p1._y;
+    const double px  = x - p1._x;
+    const double py  = y - p1._y;
+    const double t   = std::min(std::max((px * dx + py * dy) / (dx * dx + dy * dy), 0.), 1.);
+    return std::hypot(px - t * dx, py - t * dy);
+}
+} // namespace
+
+void LocationRaster::Build(
+    const std::vector<Line> & boundary,
+    const std::function<bool(const Point &)> & isInside)
+{
+    Clear();
+    if(boundary.empty()) {
+        return;
+    }
+
+    double xMin = FLT_MAX;
+    double yMin = FLT_MAX;
+    double xMax = -FLT_MAX;
+    double yMax = -FLT_MAX;
+    for(const auto & segment : boundary) {
+        for(const Point & p : {segment.GetPoint1(), segment.GetPoint2()}) {
+            xMin = std::min(xMin, p._x);
+            yMin = std::min(yMin, p._y);
+            xMax = std::max(xMax, p._x);
+            yMax = std::max(yMax, p._y);
+        }
+    }
+    const double area = (xMax - xMin + 2 * CELL_SIZE) * (yMax - yMin + 2 * CELL_SIZE);
+    const double size = std::max(CELL_SIZE, std::sqrt(area / MAX_CELLS));
+
+    // the tolerance of Line::IsInLineSegment() grows for short segments, a segment marking more
+    // than a cell around it disables the raster
+    std::vector<double> reach;
+    reach.reserve(boundary.size());
+    const double halfDiagonal = 0.5 * std::sqrt(2.) * size;
+    for(const auto & segment : boundary) {
+        const double length    = segment.GetLength();
+        const double tolerance = length > 0 ? SEGMENT_TOLERANCE / length : DBL_MAX;
+        if(!(tolerance < size)) {
+            return;
+        }
+        reach.push_back(halfDiagonal + tolerance + ROUNDING_MARGIN);
+    }
+
+    // one cell of margin keeps every point within the tolerance of a segment on the raster
+    _cellSize    = size;
+    _invCellSize = 1. / size;
+    _xMin        = xMin - size;
+    _yMin        = yMin - size;
+    _sizeX       = static_cast<int>((xMax + size - _xMin) * _invCellSize) + 1;
+    _sizeY       = static_cast<int>((yMax + size - _yMin) * _invCellSize) + 1;
+    _states.assign(static_cast<std::size_t>(_sizeX) * _sizeY, State::OUTSIDE);
+
+    std::vector<bool> boundaryCells(_states.size(), false);
+    for(std::size_t s = 0; s < boundary.size(); ++s) {
+        const Point & p1 = boundary[s].GetPoint1();
+        const Point & p2 = boundary[s].GetPoint2();
+        const int iMin   = std::max(
+            static_cast<int>((std::min(p1._x, p2._x) - reach[s] - _xMin) * _invCellSize), 0);
+        const int iMax = std::min(
+            static_cast<int>((std::max(p1._x, p2._x) + reach[s] - _xMin) * _invCellSize),
+            _sizeX - 1);
+        const int jMin = std::max(
+            static_cast<int>((std::min(p1._y, p2._y) - reach[s] - _yMin) * _invCellSize), 0);
+        const int jMax = std::min(
+            static_cast<int>((std::max(p1._y, p2._y) + reach[s] - _yMin) * _invCellSize),
+            _sizeY - 1);
+        for(int j = jMin; j <= jMax; ++j) {
+            const double y = _yMin + (j + 0.5) * _cellSize;
+            for(int i = iMin; i <= iMax; ++i) {
+                const double x = _xMin + (i + 0.5) * _cellSize;
+                if(DistanceTo(boundary[s], x, y) <= reach[s]) {
+                    boundaryCells[static_cast<std::size_t>(j) * _sizeX + i] = true;
+                }
+            }
+        }
+    }
+
+    // no boundary segment passes through a run of non boundary cells, the exact test of one
+    // cell holds for the whole run
+    for(int j = 0; j < _sizeY; ++j) {
+        const double y = _yMin + (j + 0.5) * _cellSize;
+        State state    = State::BOUNDARY;
+        for(int i = 0; i < _sizeX; ++i) {
+            const std::size_t cell = static_cast<std::size_t>(j) * _sizeX + i;
+            if(boundaryCells[cell]) {
+                _states[cell] = State::BOUNDARY;
+                state         = State::BOUNDARY;
+                continue;
+            }
+            if(state == State::BOUNDARY) {
+                const Point centre(_xMin + (i + 0.5) * _cellSize, y);
+                state = isInside(centre) ? State::INSIDE : State::OUTSIDE;
+            }
+            _states[cell] = state;
+        }
+    }
+    _built = true;
+}
+
+void LocationRaster::Clear()
+{
+    _states.clear();
+    _sizeX = 0;
+    _sizeY = 0;
+    _built = false;
+}
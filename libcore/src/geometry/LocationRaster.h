@@ -0,0 +1,96 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Raster classifying the cells around an area as inside, outside or on its boundary.
+ *
+ **/
+#pragma once
+
+#include "Line.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Raster caching a point-in-area test.
+ *
+ * Cells closer to a boundary segment than half a cell diagonal are marked BOUNDARY, all points
+ * of the other cells give the same result as the cell centre. GetState() thus answers the test
+ * for the interior cells with a single lookup and the caller only has to run the exact test on
+ * the boundary cells. The raster has to be rebuilt when the boundary changes.
+ */
+class LocationRaster
+{
+public:
+    enum class State : std::uint8_t { OUTSIDE, INSIDE, BOUNDARY };
+
+private:
+    double _xMin = 0, _yMin = 0, _cellSize = 1, _invCellSize = 1;
+    int _sizeX = 0, _sizeY = 0;
+    bool _built = false;
+    std::vector<State> _states;
+
+public:
+    /**
+     * Builds the raster over the bounding box of boundary. Points on a boundary segment, within
+     * the tolerance of Line::IsInLineSegment(), are classified by the exact test.
+     * @param boundary all segments at which the result of the exact test may change
+     * @param isInside the exact test, called for one point of each connected run of cells
+     */
+    void
+    Build(const std::vector<Line> & boundary, const std::function<bool(const Point &)> & isInside);
+
+    /**
+     * Removes all cells, IsBuilt() returns false afterwards.
+     */
+    void Clear();
+
+    /**
+     * @return true if Build() was called since the last Clear()
+     */
+    bool IsBuilt() const { return _built; }
+
+    /**
+     * @return the edge length of a cell in m
+     */
+    double GetCellSize() const { return _cellSize; }
+
+    /**
+     * @param pos the tested position
+     * @return the state of the cell containing pos, OUTSIDE beyond the raster and BOUNDARY if
+     * the raster is not built
+     */
+    State GetState(const Point & pos) const
+    {
+        if(!_built) {
+            return State::BOUNDARY;
+        }
+        // written with negations to map NaN to the exact test
+        const double i = (pos._x - _xMin) * _invCellSize;
+        const double j = (pos._y - _yMin) * _invCellSize;
+        if(!(i >= 0 && i < _sizeX && j >= 0 && j < _sizeY)) {
+            return (i == i && j == j) ? State::OUTSIDE : State::BOUNDARY;
+        }
+        return _states[static_cast<std::size_t>(j) * _sizeX + static_cast<std::size_t>(i)];
+    }
+};
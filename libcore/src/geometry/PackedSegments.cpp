@@ -0,0 +1,161 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "PackedSegments.h"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/// Line::IntersectionWith(p1, p2) accepts intersections up to 5% of [p1, p2] behind p1
+constexpr double T_MIN = -0.05;
+} // namespace
+
+void PackedSegments::Add(const Line & segment)
+{
+    _x1.push_back(segment.GetPoint1()._x);
+    _y1.push_back(segment.GetPoint1()._y);
+    _x2.push_back(segment.GetPoint2()._x);
+    _y2.push_back(segment.GetPoint2()._y);
+}
+
+void PackedSegments::Clear()
+{
+    _x1.clear();
+    _y1.clear();
+    _x2.clear();
+    _y2.clear();
+}
+
+/*
+ * The batched tests repeat the operations of Line::IntersectionWith(p1, p2) in the same order,
+ * so every lane computes the same t and u as the scalar code. Parallel segments (denominator 0)
+ * need the special cases of Line::IntersectionWith() and are tested one by one.
+ */
+std::size_t PackedSegments::FindIntersection(
+    std::size_t begin,
+    std::size_t end,
+    const Point & p1,
+    const Point & p2) const
+{
+    std::size_t i = begin;
+#if defined(__AVX__)
+    const __m256d p1x  = _mm256_set1_pd(p1._x);
+    const __m256d p1y  = _mm256_set1_pd(p1._y);
+    const __m256d rx   = _mm256_set1_pd(p2._x - p1._x);
+    const __m256d ry   = _mm256_set1_pd(p2._y - p1._y);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one  = _mm256_set1_pd(1.);
+    const __m256d tMin = _mm256_set1_pd(T_MIN);
+    for(; i + 4 <= end; i += 4) {
+        const __m256d ax = _mm256_loadu_pd(&_x1[i]);
+        const __m256d ay = _mm256_loadu_pd(&_y1[i]);
+        const __m256d sx = _mm256_sub_pd(_mm256_loadu_pd(&_x2[i]), ax);
+        const __m256d sy = _mm256_sub_pd(_mm256_loadu_pd(&_y2[i]), ay);
+        const __m256d qx = _mm256_sub_pd(ax, p1x);
+        const __m256d qy = _mm256_sub_pd(ay, p1y);
+
+        const __m256d denom = _mm256_sub_pd(_mm256_mul_pd(rx, sy), _mm256_mul_pd(ry, sx));
+        const __m256d t =
+            _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(qx, sy), _mm256_mul_pd(qy, sx)), denom);
+        const __m256d u =
+            _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(qx, ry), _mm256_mul_pd(qy, rx)), denom);
+        // ordered comparisons, NaN is not rejected just like in the scalar code
+        const __m256d missT = _mm256_or_pd(
+            _mm256_cmp_pd(t, tMin, _CMP_LT_OQ), _mm256_cmp_pd(t, one, _CMP_GT_OQ));
+        const __m256d missU = _mm256_or_pd(
+            _mm256_cmp_pd(u, zero, _CMP_LT_OQ), _mm256_cmp_pd(u, one, _CMP_GT_OQ));
+
+        const int hits     = ~_mm256_movemask_pd(_mm256_or_pd(missT, missU)) & 0xF;
+        const int parallel = _mm256_movemask_pd(_mm256_cmp_pd(denom, zero, _CMP_EQ_OQ));
+        if((hits | parallel) == 0) {
+            continue;
+        }
+        for(std::size_t lane = 0; lane < 4; ++lane) {
+            const int bit = 1 << lane;
+            if((parallel & bit) ? Intersects(i + lane, p1, p2) : (hits & bit) != 0) {
+                return i + lane;
+            }
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128d p1x  = _mm_set1_pd(p1._x);
+    const __m128d p1y  = _mm_set1_pd(p1._y);
+    const __m128d rx   = _mm_set1_pd(p2._x - p1._x);
+    const __m128d ry   = _mm_set1_pd(p2._y - p1._y);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one  = _mm_set1_pd(1.);
+    const __m128d tMin = _mm_set1_pd(T_MIN);
+    for(; i + 2 <= end; i += 2) {
+        const __m128d ax = _mm_loadu_pd(&_x1[i]);
+        const __m128d ay = _mm_loadu_pd(&_y1[i]);
+        const __m128d sx = _mm_sub_pd(_mm_loadu_pd(&_x2[i]), ax);
+        const __m128d sy = _mm_sub_pd(_mm_loadu_pd(&_y2[i]), ay);
+        const __m128d qx = _mm_sub_pd(ax, p1x);
+        const __m128d qy = _mm_sub_pd(ay, p1y);
+
+        const __m128d denom = _mm_sub_pd(_mm_mul_pd(rx, sy), _mm_mul_pd(ry, sx));
+        const __m128d t = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(qx, sy), _mm_mul_pd(qy, sx)), denom);
+        const __m128d u = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(qx, ry), _mm_mul_pd(qy, rx)), denom);
+        // ordered comparisons, NaN is not rejected just like in the scalar code
+        const __m128d missT = _mm_or_pd(_mm_cmplt_pd(t, tMin), _mm_cmpgt_pd(t, one));
+        const __m128d missU = _mm_or_pd(_mm_cmplt_pd(u, zero), _mm_cmpgt_pd(u, one));
+
+        const int hits     = ~_mm_movemask_pd(_mm_or_pd(missT, missU)) & 0x3;
+        const int parallel = _mm_movemask_pd(_mm_cmpeq_pd(denom, zero));
+        if((hits | parallel) == 0) {
+            continue;
+        }
+        for(std::size_t lane = 0; lane < 2; ++lane) {
+            const int bit = 1 << lane;
+            if((parallel & bit) ? Intersects(i + lane, p1, p2) : (hits & bit) != 0) {
+                return i + lane;
+            }
+        }
+    }
+#endif
+    for(; i < end; ++i) {
+        if(Intersects(i, p1, p2)) {
+            return i;
+        }
+    }
+    return end;
+}
+
+bool PackedSegments::Intersects(std::size_t index, const Point & p1, const Point & p2) const
+{
+    const double rx = p2._x - p1._x;
+    const double ry = p2._y - p1._y;
+    const double sx = _x2[index] - _x1[index];
+    const double sy = _y2[index] - _y1[index];
+    const double qx = _x1[index] - p1._x;
+    const double qy = _y1[index] - p1._y;
+
+    const double denom = rx * sy - ry * sx;
+    if(denom == 0.) {
+        const Line segment(Point(_x1[index], _y1[index]), Point(_x2[index], _y2[index]), 0);
+        return segment.IntersectionWith(p1, p2);
+    }
+    const double t = (qx * sy - qy * sx) / denom;
+    const double u = (qx * ry - qy * rx) / denom;
+    return !(T_MIN > t || t > 1) && !(0 > u || u > 1);
+}
@@ -0,0 +1,79 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Line segments stored as structure of arrays for batched intersection tests.
+ *
+ **/
+#pragma once
+
+#include "Line.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Line segments stored as structure of arrays.
+ *
+ * FindIntersection() tests one query segment against a range of the stored segments, several
+ * segments at once with AVX or SSE2 when the compiler targets them and one by one otherwise.
+ * The result is the same as calling Line::IntersectionWith(p1, p2) on every stored segment.
+ */
+class PackedSegments
+{
+private:
+    std::vector<double> _x1;
+    std::vector<double> _y1;
+    std::vector<double> _x2;
+    std::vector<double> _y2;
+
+public:
+    /**
+     * Appends a copy of segment.
+     * @param segment the segment
+     */
+    void Add(const Line & segment);
+
+    /**
+     * Removes all segments.
+     */
+    void Clear();
+
+    /**
+     * @return the number of segments
+     */
+    std::size_t Size() const { return _x1.size(); }
+
+    /**
+     * Returns the first segment in [begin, end) intersecting [p1, p2], the segments are tested
+     * like Line::IntersectionWith(p1, p2).
+     * @param begin index of the first tested segment
+     * @param end index behind the last tested segment
+     * @param p1 start of the query segment
+     * @param p2 end of the query segment
+     * @return index of the first intersecting segment, end if there is none
+     */
+    std::size_t
+    FindIntersection(std::size_t begin, std::size_t end, const Point & p1, const Point & p2) const;
+
+private:
+    /// test of a single segment, see FindIntersection()
+    bool Intersects(std::size_t index, const Point & p1, const Point & p2) const;
+};
@@ -195,6 +195,9 @@ bool SubRoom::RemoveWall(const Wall & w)
     auto it = std::find(_walls.begin(), _walls.end(), w);
     if(it != _walls.end()) {
         _walls.erase(it);
+        _wallGrid.Clear();
+        _wallField.Clear();
+        _locationRaster.Clear();
         return true;
     }
     return false;
@@ -212,6 +215,9 @@ bool SubRoom::AddWall(const Wall & w)
         return false;
     }
     _walls.push_back(w);
+    _wallGrid.Clear();
+    _wallField.Clear();
+    _locationRaster.Clear();
     return true;
 }
 
@@ -219,6 +225,9 @@ bool SubRoom::AddWall(const Wall & w)
 void SubRoom::AddObstacle(Obstacle * obs)
 {
     _obstacles.push_back(obs);
+    _wallGrid.Clear();
+    _wallField.Clear();
+    _locationRaster.Clear();
     CheckObstacles();
 }
 
@@ -238,6 +247,7 @@ bool SubRoom::AddCrossing(Crossing * line)
 {
     _crossings.push_back(line);
     _goalIDs.push_back(line->GetUniqueID());
+    _locationRaster.Clear();
     return true;
 }
 
@@ -251,6 +261,7 @@ bool SubRoom::RemoveTransitionByUID(int uid)
     if(it != _transitions.end()) {
         _transitions.erase(it);
         RemoveGoalID(uid);
+        _locationRaster.Clear();
         return true;
     }
     return false;
@@ -262,6 +273,7 @@ bool SubRoom::RemoveTransition(Transition * t)
     if(it != _transitions.end()) {
         _transitions.erase(it);
         RemoveGoalID(t->GetUniqueID());
+        _locationRaster.Clear();
         return true;
     }
     return false;
@@ -271,6 +283,7 @@ bool SubRoom::AddTransition(Transition * line)
 {
     _transitions.push_back(line);
     _goalIDs.push_back(line->GetUniqueID());
+    _locationRaster.Clear();
     return true;
 }
 
@@ -457,20 +470,27 @@ bool SubRoom::IsVisible(const Line & wall, const Point & position)
 // with the nearest point on the wall IS intersecting with the wall.
 bool SubRoom::IsVisible(const Point & p1, const Point & p2, bool considerHlines)
 {
-    //check intersection with Walls
-    for(const auto & wall : _walls) {
-        if(wall.IntersectionWith(p1, p2)) {
+    if(_wallGrid.IsBuilt()) {
+        //check intersection with the walls and obstacles close to the line
+        if(_wallGrid.IntersectsAny(p1, p2)) {
             return false;
         }
-    }
-
-    //check intersection with obstacles
-    for(const auto & obstacle : _obstacles) {
-        for(const auto & wall : obstacle->GetAllWalls()) {
+    } else {
+        //check intersection with Walls
+        for(const auto & wall : _walls) {
             if(wall.IntersectionWith(p1, p2)) {
                 return false;
             }
         }
+
+        //check intersection with obstacles
+        for(const auto & obstacle : _obstacles) {
+            for(const auto & wall : obstacle->GetAllWalls()) {
+                if(wall.IntersectionWith(p1, p2)) {
+                    return false;
+                }
+            }
+        }
     }
 
     if(considerHlines) {
@@ -1072,8 +1092,18 @@ double NormalSubRoom::Xintercept(const Point & point1, const Point & point2, dou
 //@todo: ar.graf: UnivFF have subroomPtr Info for every gridpoint. Info should be used in DirectionFF instead of this
 bool NormalSubRoom::IsInSubRoom(const Point & p) const
 {
+    // away from walls, doors and obstacles the raster knows the result
+    switch(_locationRaster.GetState(p)) {
+        case LocationRaster::State::INSIDE:
+            return true;
+        case LocationRaster::State::OUTSIDE:
+            return false;
+        case LocationRaster::State::BOUNDARY:
+            break;
+    }
+
     // if pedestrian is stuck in obstacle or on obstacle line, return false
-    for(polygon_type obs : _boostPolyObstacles) {
+    for(const polygon_type & obs : _boostPolyObstacles) {
         if(boost::geometry::within(p, obs)) {
             return false;
         }
@@ -1411,6 +1441,72 @@ void SubRoom::Update()
 
     CalculateArea();
     CreateBoostPoly();
+    UpdateWallGrid();
+    if(_wallFieldCutoff > 0) {
+        UpdateWallDistanceField(_wallFieldCutoff);
+    }
+    UpdateLocationRaster();
+}
+
+void SubRoom::UpdateWallGrid()
+{
+    _wallGrid.Build(GetWallSegments());
+}
+
+void SubRoom::UpdateWallDistanceField(double cutoff)
+{
+    _wallFieldCutoff = cutoff;
+    _wallField.Build(GetWallSegments(), cutoff);
+}
+
+void SubRoom::UpdateLocationRaster()
+{
+    // IsInSubRoom() only changes its result at these segments. Stairs and escalators inherit
+    // NormalSubRoom::IsInSubRoom() and need the raster as well, their _poly is the shifted polygon
+    std::vector<Line> boundary;
+    for(std::size_t i = 0; i < _poly.size(); ++i) {
+        const Point & p1 = _poly[i];
+        const Point & p2 = _poly[(i + 1) % _poly.size()];
+        if(p1 != p2) {
+            boundary.emplace_back(p1, p2, 0);
+        }
+    }
+    for(const auto & obstacle : _obstacles) {
+        for(const auto & wall : obstacle->GetAllWalls()) {
+            boundary.emplace_back(wall.GetPoint1(), wall.GetPoint2(), 0);
+        }
+        const std::vector<Point> & polygon = obstacle->GetPolygon();
+        for(std::size_t i = 0; i < polygon.size(); ++i) {
+            const Point & p1 = polygon[i];
+            const Point & p2 = polygon[(i + 1) % polygon.size()];
+            if(p1 != p2) {
+                boundary.emplace_back(p1, p2, 0);
+            }
+        }
+    }
+    for(const auto & transition : _transitions) {
+        boundary.emplace_back(transition->GetPoint1(), transition->GetPoint2(), 0);
+    }
+    for(const auto & crossing : _crossings) {
+        boundary.emplace_back(crossing->GetPoint1(), crossing->GetPoint2(), 0);
+    }
+
+    // the raster is empty while it is built, IsInSubRoom() runs the exact test
+    _locationRaster.Build(boundary, [this](const Point & p) { return IsInSubRoom(p); });
+}
+
+std::vector<Line> SubRoom::GetWallSegments() const
+{
+    std::vector<Line> segments;
+    for(const auto & wall : _walls) {
+        segments.emplace_back(wall.GetPoint1(), wall.GetPoint2(), 0);
+    }
+    for(const auto & obstacle : _obstacles) {
+        for(const auto & wall : obstacle->GetAllWalls()) {
+            segments.emplace_back(wall.GetPoint1(), wall.GetPoint2(), 0);
+        }
+    }
+    return segments;
 }
 
 
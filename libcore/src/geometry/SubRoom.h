@@ -26,6 +26,9 @@
  **/
 #pragma once
 
+#include "LocationRaster.h"
+#include "WallDistanceField.h"
+#include "WallGrid.h"
 #include "general/Macros.h"
 #include "routing/global_shortest/DTriangulation.h"
 
@@ -80,6 +83,8 @@ private:
     /// storing and incrementing the total number of subrooms
     static int _static_uid;
 
+    /// walls and obstacle walls for the wall grid and the wall distance field
+    std::vector<Line> GetWallSegments() const;
 
 protected:
     std::vector<Wall> _walls;
@@ -92,6 +97,14 @@ protected:
     std::vector<double> _poly_help_constatnt; //for the function IsInsidePolygon, a.brkic
     std::vector<double> _poly_help_multiple;  //for the function IsInsidePolygon, a.brkic
     std::vector<Obstacle *> _obstacles;
+    /// walls and obstacle walls for the visibility checks, see UpdateWallGrid()
+    WallGrid _wallGrid;
+    /// walls and obstacle walls for the repulsive wall forces, see UpdateWallDistanceField()
+    WallDistanceField _wallField;
+    /// cutoff of the last UpdateWallDistanceField(), 0 if the field was never requested
+    double _wallFieldCutoff = 0;
+    /// cached result of IsInSubRoom() away from the boundary, see UpdateLocationRaster()
+    LocationRaster _locationRaster;
 
 public:
     /**
@@ -401,6 +414,33 @@ public:
      */
     void Update();
 
+    /**
+     * Rebuilds the grid over the walls and obstacles used by IsVisible(). Changing the walls or
+     * obstacles discards the grid and IsVisible() tests all walls until this is called again.
+     */
+    void UpdateWallGrid();
+
+    /**
+     * Rebuilds the distance field over the walls and obstacles used by the repulsive wall forces.
+     * Changing the walls or obstacles discards the field, Update() rebuilds it with the same
+     * cutoff.
+     * @param cutoff walls farther away from an agent than cutoff (in m) do not act on it
+     */
+    void UpdateWallDistanceField(double cutoff);
+
+    /**
+     * @return the distance field of the walls, not built unless UpdateWallDistanceField() was
+     * called
+     */
+    const WallDistanceField & GetWallDistanceField() const { return _wallField; }
+
+    /**
+     * Rebuilds the raster caching IsInSubRoom() for the points away from the walls, doors and
+     * obstacles. Changing the walls, doors or obstacles discards the raster and IsInSubRoom()
+     * runs the exact test everywhere until this is called again.
+     */
+    void UpdateLocationRaster();
+
 #ifdef _SIMULATOR
 
     virtual bool IsInSubRoom(Pedestrian * ped) const;
@@ -0,0 +1,128 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "WallDistanceField.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+/// edge of a cell in m, enlarged for very large subrooms
+constexpr double CELL_SIZE = 0.25;
+
+/// upper bound of the number of cells of one field
+constexpr double MAX_CELLS = 1 << 20;
+} // namespace
+
+void WallDistanceField::Build(const std::vector<Line> & segments, double cutoff)
+{
+    _segments = segments;
+    _cutoff   = std::max(cutoff, 0.);
+    _built    = true;
+
+    double xMin = FLT_MAX;
+    double yMin = FLT_MAX;
+    double xMax = -FLT_MAX;
+    double yMax = -FLT_MAX;
+    for(const auto & segment : _segments) {
+        for(const Point & p : {segment.GetPoint1(), segment.GetPoint2()}) {
+            xMin = std::min(xMin, p._x);
+            yMin = std::min(yMin, p._y);
+            xMax = std::max(xMax, p._x);
+            yMax = std::max(yMax, p._y);
+        }
+    }
+    if(_segments.empty()) {
+        xMin = yMin = xMax = yMax = 0;
+    }
+    // no segment is within the cutoff of a point outside of the enlarged bounding box
+    xMin -= _cutoff;
+    yMin -= _cutoff;
+    xMax += _cutoff;
+    yMax += _cutoff;
+
+    const double area = (xMax - xMin + CELL_SIZE) * (yMax - yMin + CELL_SIZE);
+    _cellSize         = std::max(CELL_SIZE, std::sqrt(area / MAX_CELLS));
+    _invCellSize      = 1. / _cellSize;
+    _xMin             = xMin;
+    _yMin             = yMin;
+    _sizeX            = static_cast<int>((xMax - xMin) * _invCellSize) + 1;
+    _sizeY            = static_cast<int>((yMax - yMin) * _invCellSize) + 1;
+    _truncation       = _cutoff + 0.5 * std::sqrt(2.) * _cellSize;
+
+    const std::size_t cells = static_cast<std::size_t>(_sizeX) * _sizeY;
+
+    // a segment is a candidate of a cell if it is within the truncation of the cell centre,
+    // that covers every point of the cell within the cutoff
+    auto forEachCell = [this](const Line & segment, auto && fn) {
+        const Point & p1 = segment.GetPoint1();
+        const Point & p2 = segment.GetPoint2();
+        const int iMin   = std::max(
+            static_cast<int>((std::min(p1._x, p2._x) - _truncation - _xMin) * _invCellSize), 0);
+        const int iMax = std::min(
+            static_cast<int>((std::max(p1._x, p2._x) + _truncation - _xMin) * _invCellSize),
+            _sizeX - 1);
+        const int jMin = std::max(
+            static_cast<int>((std::min(p1._y, p2._y) - _truncation - _yMin) * _invCellSize), 0);
+        const int jMax = std::min(
+            static_cast<int>((std::max(p1._y, p2._y) + _truncation - _yMin) * _invCellSize),
+            _sizeY - 1);
+        for(int j = jMin; j <= jMax; ++j) {
+            const double y = _yMin + (j + 0.5) * _cellSize;
+            for(int i = iMin; i <= iMax; ++i) {
+                const double x              = _xMin + (i + 0.5) * _cellSize;
+                const double distanceSquare = DistanceSquare(segment, x, y);
+                if(distanceSquare <= _truncation * _truncation) {
+                    fn(static_cast<std::size_t>(j) * _sizeX + i);
+                }
+            }
+        }
+    };
+
+    // counting sort of the (cell, segment) pairs by cell
+    _cellStart.assign(cells + 1, 0);
+    for(const auto & segment : _segments) {
+        forEachCell(segment, [this](std::size_t cell) { ++_cellStart[cell + 1]; });
+    }
+    std::partial_sum(std::begin(_cellStart), std::end(_cellStart), std::begin(_cellStart));
+
+    _cellSegments.resize(_cellStart.back());
+    std::vector<std::size_t> cursor(std::begin(_cellStart), std::end(_cellStart) - 1);
+    for(std::size_t s = 0; s < _segments.size(); ++s) {
+        forEachCell(_segments[s], [this, s, &cursor](std::size_t cell) {
+            _cellSegments[cursor[cell]++] = static_cast<std::uint32_t>(s);
+        });
+    }
+}
+
+void WallDistanceField::Clear()
+{
+    _segments.clear();
+    _cellSegments.clear();
+    _cellStart.clear();
+    _sizeX      = 0;
+    _sizeY      = 0;
+    _cutoff     = 0;
+    _truncation = 0;
+    _built      = false;
+}
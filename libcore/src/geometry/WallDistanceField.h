@@ -0,0 +1,136 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Raster of the walls of a subroom close to each cell for the repulsive wall forces.
+ *
+ **/
+#pragma once
+
+#include "Line.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Raster over a set of wall segments for the repulsive wall forces of the operational models.
+ *
+ * Every cell stores the segments that may be closer than the cutoff to any point of the cell, so
+ * ForEachWallInCutoff() evaluates only the segments closer than the cutoff instead of all walls of
+ * a subroom. The field keeps copies of the segments and has to be rebuilt when the walls change.
+ */
+class WallDistanceField
+{
+private:
+    double _xMin = 0, _yMin = 0, _cellSize = 1, _invCellSize = 1;
+    /// interaction cutoff and the largest distance of a candidate segment from a cell centre
+    double _cutoff = 0, _truncation = 0;
+    int _sizeX = 0, _sizeY = 0;
+    bool _built = false;
+
+    std::vector<Line> _segments;
+    /// segments of all cells sorted by cell, cell c holds [_cellStart[c], _cellStart[c + 1])
+    std::vector<std::uint32_t> _cellSegments;
+    std::vector<std::size_t> _cellStart;
+
+public:
+    /**
+     * Builds the field over segments.
+     * @param segments the wall segments
+     * @param cutoff segments farther away than cutoff (in m) are skipped by ForEachWallInCutoff()
+     */
+    void Build(const std::vector<Line> & segments, double cutoff);
+
+    /**
+     * Removes all segments, IsBuilt() returns false afterwards.
+     */
+    void Clear();
+
+    /**
+     * @return true if Build() was called since the last Clear()
+     */
+    bool IsBuilt() const { return _built; }
+
+    /**
+     * @return the number of segments in the field
+     */
+    std::size_t Size() const { return _segments.size(); }
+
+    /**
+     * @return the cutoff the field was built with
+     */
+    double GetCutoff() const { return _cutoff; }
+
+    /**
+     * @return the edge length of a cell in m
+     */
+    double GetCellSize() const { return _cellSize; }
+
+    /**
+     * Calls fn for every segment closer than the cutoff to pos, in the order passed to Build().
+     * @param pos the position of the agent
+     * @param fn callable taking a const Line &
+     */
+    template <typename F>
+    void ForEachWallInCutoff(const Point & pos, F && fn) const
+    {
+        std::size_t cell;
+        if(!GetCell(pos._x, pos._y, cell)) {
+            return;
+        }
+        const double cutoffSquare = _cutoff * _cutoff;
+        for(std::size_t e = _cellStart[cell]; e < _cellStart[cell + 1]; ++e) {
+            const Line & segment = _segments[_cellSegments[e]];
+            if(DistanceSquare(segment, pos._x, pos._y) <= cutoffSquare) {
+                fn(segment);
+            }
+        }
+    }
+
+private:
+    /// cell containing (x, y), false outside of the raster
+    bool GetCell(double x, double y, std::size_t & cell) const
+    {
+        // written with negations to reject NaN
+        const double i = (x - _xMin) * _invCellSize;
+        const double j = (y - _yMin) * _invCellSize;
+        if(!(i >= 0 && i < _sizeX && j >= 0 && j < _sizeY)) {
+            return false;
+        }
+        cell = static_cast<std::size_t>(j) * _sizeX + static_cast<std::size_t>(i);
+        return true;
+    }
+
+    /// squared distance of (x, y) to the segment, computed on the coordinates
+    static double DistanceSquare(const Line & segment, double x, double y)
+    {
+        const Point & p1  = segment.GetPoint1();
+        const Point & p2  = segment.GetPoint2();
+        const double dx   = p2._x - p1._x;
+        const double dy   = p2._y - p1._y;
+        const double len2 = dx * dx + dy * dy;
+        double t          = len2 > 0 ? ((x - p1._x) * dx + (y - p1._y) * dy) / len2 : 0;
+        t                 = t < 0 ? 0 : (t > 1 ? 1 : t);
+        const double ex   = p1._x + t * dx - x;
+        const double ey   = p1._y + t * dy - y;
+        return ex * ex + ey * ey;
+    }
+};
@@ -0,0 +1,177 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "WallGrid.h"
+
+#include "general/Macros.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+/// smallest edge of a cell in m
+constexpr double MIN_CELL_SIZE = 0.5;
+
+/// up to this number of segments testing all of them is faster than visiting the cells
+constexpr std::size_t MAX_LINEAR_SEGMENTS = 8;
+
+/**
+ * Line::IntersectionWith(p1, p2) accepts intersections up to 5% of the query segment behind p1
+ * and compares points with J_EPS. The query box has to cover both.
+ */
+constexpr double QUERY_EXTENSION = 0.05;
+constexpr double QUERY_MARGIN    = 2 * J_EPS;
+} // namespace
+
+void WallGrid::Build(const std::vector<Line> & segments)
+{
+    _segments.Clear();
+    for(const auto & segment : segments) {
+        _segments.Add(segment);
+    }
+    _built = true;
+
+    _xMin = FLT_MAX;
+    _yMin = FLT_MAX;
+    _xMax = -FLT_MAX;
+    _yMax = -FLT_MAX;
+    for(const auto & segment : segments) {
+        for(const Point & p : {segment.GetPoint1(), segment.GetPoint2()}) {
+            _xMin = std::min(_xMin, p._x);
+            _yMin = std::min(_yMin, p._y);
+            _xMax = std::max(_xMax, p._x);
+            _yMax = std::max(_yMax, p._y);
+        }
+    }
+    if(segments.empty()) {
+        _xMin = _yMin = _xMax = _yMax = 0;
+    }
+
+    // about one cell per segment, a single cell for few segments
+    const double area  = std::max((_xMax - _xMin) * (_yMax - _yMin), 1.);
+    const double count = std::max(static_cast<double>(segments.size()), 1.);
+    _cellSize          = std::max(std::sqrt(area / count), MIN_CELL_SIZE);
+    if(segments.size() <= MAX_LINEAR_SEGMENTS) {
+        _cellSize = std::max({_xMax - _xMin, _yMax - _yMin, MIN_CELL_SIZE});
+    }
+    _invCellSize = 1. / _cellSize;
+    _sizeX       = static_cast<int>((_xMax - _xMin) * _invCellSize) + 1;
+    _sizeY       = static_cast<int>((_yMax - _yMin) * _invCellSize) + 1;
+
+    // counting sort of the (cell, segment) pairs by cell
+    _cellStart.assign(static_cast<std::size_t>(_sizeX) * _sizeY + 1, 0);
+    auto forEachCell = [this](const Line & segment, auto && fn) {
+        const Point & p1 = segment.GetPoint1();
+        const Point & p2 = segment.GetPoint2();
+        const int iMin   = GetCellX(std::min(p1._x, p2._x));
+        const int iMax   = GetCellX(std::max(p1._x, p2._x));
+        const int jMin   = GetCellY(std::min(p1._y, p2._y));
+        const int jMax   = GetCellY(std::max(p1._y, p2._y));
+        for(int j = jMin; j <= jMax; ++j) {
+            for(int i = iMin; i <= iMax; ++i) {
+                fn(static_cast<std::size_t>(j) * _sizeX + i);
+            }
+        }
+    };
+    for(const auto & segment : segments) {
+        forEachCell(segment, [this](std::size_t cell) { ++_cellStart[cell + 1]; });
+    }
+    std::partial_sum(std::begin(_cellStart), std::end(_cellStart), std::begin(_cellStart));
+
+    std::vector<std::uint32_t> order(_cellStart.back());
+    std::vector<std::size_t> cursor(std::begin(_cellStart), std::end(_cellStart) - 1);
+    for(std::size_t s = 0; s < segments.size(); ++s) {
+        forEachCell(segments[s], [s, &order, &cursor](std::size_t cell) {
+            order[cursor[cell]++] = static_cast<std::uint32_t>(s);
+        });
+    }
+    _cellSegments.Clear();
+    for(const auto s : order) {
+        _cellSegments.Add(segments[s]);
+    }
+}
+
+void WallGrid::Clear()
+{
+    _segments.Clear();
+    _cellSegments.Clear();
+    _cellStart.clear();
+    _sizeX = _sizeY = 0;
+    _built          = false;
+}
+
+bool WallGrid::IntersectsAny(const Point & p1, const Point & p2) const
+{
+    // computed on the coordinates, the Point operators are not inlined
+    const double xStart = p1._x - (p2._x - p1._x) * QUERY_EXTENSION;
+    const double yStart = p1._y - (p2._y - p1._y) * QUERY_EXTENSION;
+    const double xMin   = std::min(xStart, p2._x) - QUERY_MARGIN;
+    const double xMax   = std::max(xStart, p2._x) + QUERY_MARGIN;
+    const double yMin   = std::min(yStart, p2._y) - QUERY_MARGIN;
+    const double yMax   = std::max(yStart, p2._y) + QUERY_MARGIN;
+    // no wall can be hit outside of the bounding box of all walls
+    if(xMin > _xMax || xMax < _xMin || yMin > _yMax || yMax < _yMin) {
+        return false;
+    }
+
+    const int iMin = GetCellX(xMin);
+    const int iMax = GetCellX(xMax);
+    const int jMin = GetCellY(yMin);
+    const int jMax = GetCellY(yMax);
+
+    // long queries would test the same segments in many cells
+    const std::size_t cells = static_cast<std::size_t>(iMax - iMin + 1) * (jMax - jMin + 1);
+    if(cells > 1 && cells >= _segments.Size()) {
+        return _segments.FindIntersection(0, _segments.Size(), p1, p2) != _segments.Size();
+    }
+
+    // the cells of a row are contiguous, segments spanning several cells may be tested twice
+    for(int j = jMin; j <= jMax; ++j) {
+        const std::size_t row   = static_cast<std::size_t>(j) * _sizeX;
+        const std::size_t begin = _cellStart[row + iMin];
+        const std::size_t end   = _cellStart[row + iMax + 1];
+        if(_cellSegments.FindIntersection(begin, end, p1, p2) != end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int WallGrid::GetCellX(double x) const
+{
+    // truncation equals floor for positive values, written with negations to map NaN to cell 0
+    const double cell = (x - _xMin) * _invCellSize;
+    if(!(cell > 0)) {
+        return 0;
+    }
+    return !(cell < _sizeX) ? _sizeX - 1 : static_cast<int>(cell);
+}
+
+int WallGrid::GetCellY(double y) const
+{
+    const double cell = (y - _yMin) * _invCellSize;
+    if(!(cell > 0)) {
+        return 0;
+    }
+    return !(cell < _sizeY) ? _sizeY - 1 : static_cast<int>(cell);
+}
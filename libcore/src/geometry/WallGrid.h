@@ -0,0 +1,90 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Uniform grid over the wall segments of a subroom for fast segment queries.
+ *
+ **/
+#pragma once
+
+#include "Line.h"
+#include "PackedSegments.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Uniform grid over a set of wall segments.
+ *
+ * Every segment is registered in all cells its bounding box overlaps. A segment query only tests
+ * the segments registered in the cells overlapped by the bounding box of the query, so the
+ * number of intersection tests depends on the walls close to the query instead of all walls of a
+ * subroom. The grid keeps packed copies of the segments, sorted by cell, for the batched tests of
+ * PackedSegments and has to be rebuilt when the walls change.
+ */
+class WallGrid
+{
+private:
+    double _xMin = 0, _yMin = 0, _xMax = 0, _yMax = 0, _cellSize = 1, _invCellSize = 1;
+    int _sizeX = 0, _sizeY = 0;
+    bool _built = false;
+
+    PackedSegments _segments;
+    /// segments of all cells sorted by cell, cell c holds [_cellStart[c], _cellStart[c + 1])
+    PackedSegments _cellSegments;
+    std::vector<std::size_t> _cellStart;
+
+public:
+    /**
+     * Builds the grid over segments.
+     * @param segments the wall segments
+     */
+    void Build(const std::vector<Line> & segments);
+
+    /**
+     * Removes all segments, IsBuilt() returns false afterwards.
+     */
+    void Clear();
+
+    /**
+     * @return true if Build() was called since the last Clear()
+     */
+    bool IsBuilt() const { return _built; }
+
+    /**
+     * @return the number of segments in the grid
+     */
+    std::size_t Size() const { return _segments.Size(); }
+
+    /**
+     * Returns whether any segment intersects the segment [p1, p2]. The result is the same as
+     * testing every segment with Line::IntersectionWith(p1, p2).
+     * @param p1 start of the query segment
+     * @param p2 end of the query segment
+     * @return true if at least one segment intersects [p1, p2]
+     */
+    bool IntersectsAny(const Point & p1, const Point & p2) const;
+
+private:
+    /// cell of the coordinate clamped to the grid
+    int GetCellX(double x) const;
+    int GetCellY(double y) const;
+};
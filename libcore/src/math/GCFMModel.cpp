@@ -35,9 +35,19 @@
 #include "geometry/SubRoom.h"
 #include "geometry/Wall.h"
 #include "neighborhood/NeighborhoodSearch.h"
+#include "pedestrian/AgentsKinematics.h"
+#include "pedestrian/PackedEllipses.h"
 #include "pedestrian/Pedestrian.h"
 
 #include <Logger.h>
+#include <algorithm>
+
+namespace
+{
+/// largest change of the velocity (m/s) of an agent in one sub-step, at the usual time step of
+/// 0.01 s only agents in dense crowds exceed it
+constexpr double MAX_SUBSTEP_DV = 0.05;
+} // namespace
 
 GCFMModel::GCFMModel(
     std::shared_ptr<DirectionManager> dir,
@@ -48,17 +58,24 @@ GCFMModel::GCFMModel(
     double intp_widthped,
     double intp_widthwall,
     double maxfped,
-    double maxfwall)
+    double maxfwall,
+    double wallCutoff,
+    bool pairwiseForcePed,
+    int maxSubSteps)
 {
-    _direction      = dir;
-    _nuPed          = nuped;
-    _nuWall         = nuwall;
-    _intp_widthPed  = intp_widthped;
-    _intp_widthWall = intp_widthwall;
-    _maxfPed        = maxfped;
-    _maxfWall       = maxfwall;
-    _distEffMaxPed  = dist_effPed;
-    _distEffMaxWall = dist_effWall;
+    _direction        = dir;
+    _nuPed            = nuped;
+    _nuWall           = nuwall;
+    _intp_widthPed    = intp_widthped;
+    _intp_widthWall   = intp_widthwall;
+    _maxfPed          = maxfped;
+    _maxfWall         = maxfwall;
+    _distEffMaxPed    = dist_effPed;
+    _distEffMaxWall   = dist_effWall;
+    _wallCutoff       = wallCutoff;
+    _pairwiseForcePed = pairwiseForcePed;
+    _maxSubSteps      = maxSubSteps;
+    _computeStep      = nullptr; // selected in Init()
 }
 
 GCFMModel::~GCFMModel(void) {}
@@ -67,6 +84,21 @@ GCFMModel::~GCFMModel(void) {}
 bool GCFMModel::Init(Building * building)
 {
     _direction->Init(building);
+    if(_wallCutoff > 0) {
+        building->InitWallDistanceFields(_wallCutoff);
+    }
+
+    // all combinations of the policies, [pairwise][wallField][floorfieldDirection]
+    static const ComputeStepFunction steps[2][2][2] = {
+        {{&GCFMModel::ComputeStep<false, false, false>,
+          &GCFMModel::ComputeStep<false, false, true>},
+         {&GCFMModel::ComputeStep<false, true, false>,
+          &GCFMModel::ComputeStep<false, true, true>}},
+        {{&GCFMModel::ComputeStep<true, false, false>,
+          &GCFMModel::ComputeStep<true, false, true>},
+         {&GCFMModel::ComputeStep<true, true, false>,
+          &GCFMModel::ComputeStep<true, true, true>}}};
+    _computeStep = steps[_pairwiseForcePed][_wallCutoff > 0][IsFloorfieldDirection()];
 
     const std::vector<Pedestrian *> & allPeds = building->GetAllPedestrians();
     size_t peds_size                          = allPeds.size();
@@ -106,109 +138,174 @@ void GCFMModel::ComputeNextTimeStep(
     double deltaT,
     Building * building,
     int periodic)
+{
+    (this->*_computeStep)(current, deltaT, building, periodic);
+}
+
+template <bool pairwise, bool wallField, bool floorfieldDirection>
+void GCFMModel::ComputeStep(double current, double deltaT, Building * building, int periodic)
 {
     double delta = 1.5;
 
     // collect all pedestrians in the simulation.
     const std::vector<Pedestrian *> & allPeds = building->GetAllPedestrians();
+    AgentsKinematics & kinematics             = building->GetKinematics();
 
-    unsigned int nSize = allPeds.size();
-    int nThreads       = omp_get_max_threads();
+    const std::size_t nSize = allPeds.size();
+    int nThreads            = omp_get_max_threads();
+    if((int) nSize <= nThreads)
+        nThreads = 1; // not worthy to parallelize
 
+    // the work items are blocks of neighbouring cells, crowded blocks take longer than empty ones
+    const std::size_t nWorkItems = UpdateWorkItems(*building);
+    std::vector<Point> result_acc(nSize);
+    std::vector<char> toRemove(nSize, false);
+
+    // in the pairwise mode every thread keeps the forces of the pairs it evaluated, they are
+    // added up in the order of the pedestrians, independent of the thread that evaluated a pair
+    std::vector<Point> pairForce;
+    if(pairwise) {
+        _pairForces.resize(nThreads);
+        for(auto & forces : _pairForces) {
+            forces.clear();
+        }
+        _pairRanges.resize(nSize);
+        pairForce.resize(nSize);
+    }
 
-    int partSize;
-    partSize = ((int) nSize > nThreads) ? (int) (nSize / nThreads) : (int) nSize;
-    if(partSize == (int) nSize)
-        nThreads = 1; // not worthy to parallelize
+    // agents whose velocity changes too much in one step, they are integrated with sub-steps on
+    // the buffers below and move at the end of the step like all other agents
+    std::vector<std::size_t> contacts;
+    std::vector<int> contactOf; // position in contacts, -1 for the other agents
+    std::vector<Point> startPos;
+    std::vector<Point> subPos;
+    std::vector<Point> subV;
+    int nSubSteps = 1;
 
-    int debugPed = -10;
 #pragma omp parallel default(shared) num_threads(nThreads)
     {
-        std::vector<Point> result_acc = std::vector<Point>();
-        result_acc.reserve(2200);
-
-        const int threadID = omp_get_thread_num();
-
-        int start = threadID * partSize;
-        int end;
-        end = (threadID < nThreads - 1) ? (threadID + 1) * partSize - 1 : (int) (nSize - 1);
-
-        for(int p = start; p <= end; ++p) {
-            Pedestrian * ped  = allPeds[p];
-            Room * room       = building->GetRoom(ped->GetRoomID());
-            SubRoom * subroom = room->GetSubRoom(ped->GetSubRoomID());
-            double normVi     = ped->GetV().ScalarProduct(ped->GetV());
-            double tmp        = (ped->GetV0Norm() + delta) * (ped->GetV0Norm() + delta);
-            if(normVi > tmp && ped->GetV0Norm() > 0) {
-                fprintf(
-                    stderr,
-                    "GCFMModel::calculateForce() WARNING: actual velocity (%f) of iped %d "
-                    "is bigger than desired velocity (%f) at time: %fs (periodic=%d)\n",
-                    sqrt(normVi),
-                    ped->GetID(),
-                    ped->GetV0Norm(),
-                    current,
-                    periodic);
-                // remove the pedestrian and abort
-                building->DeletePedestrian(ped);
-                // TODO KKZ track deleted peds
-                LOG_ERROR("One ped was removed due to high velocity");
+        const int thread = omp_get_thread_num();
+        // refilled for every pedestrian of this thread, Clear() does not free the arrays
+        PackedEllipses neighbours;
+        std::vector<double> distEff;
+
+#pragma omp for schedule(dynamic)
+        for(std::size_t w = 0; w < nWorkItems; ++w) {
+            for(std::size_t n = _workItemStart[w]; n < _workItemStart[w + 1]; ++n) {
+                const std::size_t p = _workOrder[n];
+
+                Pedestrian * ped = allPeds[p];
+                double normVi    = ped->GetV().ScalarProduct(ped->GetV());
+                double tmp       = (ped->GetV0Norm() + delta) * (ped->GetV0Norm() + delta);
+                if(normVi > tmp && ped->GetV0Norm() > 0) {
+                    fprintf(
+                        stderr,
+                        "GCFMModel::calculateForce() WARNING: actual velocity (%f) of iped %d "
+                        "is bigger than desired velocity (%f) at time: %fs (periodic=%d)\n",
+                        sqrt(normVi),
+                        ped->GetID(),
+                        ped->GetV0Norm(),
+                        current,
+                        periodic);
+                    // remove the pedestrian after this step, the others still refer to it
+                    toRemove[p] = true;
+                    // TODO KKZ track deleted peds
+                    LOG_ERROR("One ped was removed due to high velocity");
+                }
+
+                result_acc[p] = Acceleration<pairwise, wallField, floorfieldDirection>(
+                    building, p, thread, neighbours, distEff);
+            } // for n
+        }     // for w
+
+        if(pairwise) {
+#pragma omp single
+            {
+                for(std::size_t p = 0; p < nSize; ++p) {
+                    const PairRange & range = _pairRanges[p];
+                    for(std::size_t n = range.begin; n < range.end; ++n) {
+                        const PairForce & pair = _pairForces[range.thread][n];
+                        pairForce[pair.ped1] += pair.force12;
+                        pairForce[pair.ped2] += pair.force21;
+                    }
+                }
+                for(std::size_t p = 0; p < nSize; ++p) {
+                    result_acc[p] += pairForce[p] / allPeds[p]->GetMass();
+                }
             }
+        }
 
-            Point F_rep;
-            std::vector<Pedestrian *> neighbours =
-                building->GetNeighborhoodSearch().GetNeighbourhood(ped);
-            std::vector<SubRoom *> emptyVector;
-
-            int neighborsSize = neighbours.size();
-            for(int i = 0; i < neighborsSize; i++) {
-                Pedestrian * ped1   = neighbours[i];
-                Point p1            = ped->GetPos();
-                Point p2            = ped1->GetPos();
-                bool ped_is_visible = building->IsVisible(p1, p2, emptyVector, false);
-                if(!ped_is_visible)
-                    continue;
-                //if they are in the same subroom
-                if(ped->GetUniqueRoomID() == ped1->GetUniqueRoomID()) {
-                    F_rep = F_rep + ForceRepPed(ped, ped1);
-                } else {
-                    // or in neighbour subrooms
-                    SubRoom * sb2 =
-                        building->GetRoom(ped1->GetRoomID())->GetSubRoom(ped1->GetSubRoomID());
-                    if(subroom->IsDirectlyConnectedWith(sb2)) {
-                        F_rep = F_rep + ForceRepPed(ped, ped1);
+        // the agents in contact are evaluated again in every sub-step. They see each other at their
+        // sub-step positions, the kinematics are updated after each sub-step, and all other agents
+        // at the beginning of the step. ForceDriv() overwrites the last desired direction in every
+        // sub-step, this is intended: the direction follows the sub-step position and the value of
+        // the last sub-step is kept.
+        if(_maxSubSteps > 1) {
+#pragma omp single
+            {
+                contactOf.assign(nSize, -1);
+                for(std::size_t p = 0; p < nSize; ++p) {
+                    // agents waiting for their premovement do not move
+                    if(Pedestrian::GetGlobalTime() < allPeds[p]->GetPremovementTime())
+                        continue;
+                    const int subSteps = SubSteps(result_acc[p], deltaT);
+                    if(subSteps > 1) {
+                        contactOf[p] = static_cast<int>(contacts.size());
+                        contacts.push_back(p);
+                        startPos.push_back(allPeds[p]->GetPos());
+                        subPos.push_back(allPeds[p]->GetPos());
+                        subV.push_back(allPeds[p]->GetV());
+                        nSubSteps = std::max(nSubSteps, subSteps);
                     }
                 }
-            } //for peds
-
-
-            //repulsive forces to the walls and transitions that are not my target
-            Point repwall = ForceRepRoom(allPeds[p], subroom);
-            Point fd      = ForceDriv(ped, room);
-            Point acc     = (fd + F_rep + repwall) / ped->GetMass();
-
-            if(ped->GetID() == debugPed) {
-                printf(
-                    "\nacc= %f %f, fd= %f, %f,  repPed = %f %f, repWall= %f, %f\n",
-                    acc._x,
-                    acc._y,
-                    fd._x,
-                    fd._y,
-                    F_rep._x,
-                    F_rep._y,
-                    repwall._x,
-                    repwall._y);
+            }
+        }
+        const double h = deltaT / nSubSteps;
+
+        for(int s = 0; s < nSubSteps && !contacts.empty(); ++s) {
+            if(s > 0) {
+#pragma omp for schedule(dynamic)
+                for(std::size_t c = 0; c < contacts.size(); ++c) {
+                    result_acc[contacts[c]] = Acceleration<false, wallField, floorfieldDirection>(
+                        building, contacts[c], thread, neighbours, distEff);
+                }
             }
 
-            result_acc.push_back(acc);
+            // the implicit barrier of the loops above separates the evaluation from the update
+#pragma omp for schedule(static)
+            for(std::size_t c = 0; c < contacts.size(); ++c) {
+                Pedestrian * ped = allPeds[contacts[c]];
+                subV[c]          = subV[c] + result_acc[contacts[c]] * h;
+                subPos[c]        = subPos[c] + subV[c] * h;
+                // only the ellipse follows the sub-steps, the pedestrian moves at the end
+                JEllipse E = ped->GetEllipse();
+                E.SetCenter(subPos[c]);
+                E.SetV(subV[c]);
+                ped->SetEllipse(E);
+                ped->SetPhiPed();
+                kinematics.Store(ped->GetKinematicsIndex(), *ped);
+            }
         }
 
-#pragma omp barrier
-        // update
-        for(int p = start; p <= end; ++p) {
+        // every agent moves once per step, so the door crossings, the recorded positions and the
+        // time in jam are not affected by the sub-steps
+#pragma omp for schedule(static)
+        for(std::size_t p = 0; p < nSize; ++p) {
             Pedestrian * ped = allPeds[p];
-            Point v_neu      = ped->GetV() + result_acc[p - start] * deltaT;
-            Point pos_neu    = ped->GetPos() + v_neu * deltaT;
+            const int c      = contacts.empty() ? -1 : contactOf[p];
+            Point v_neu;
+            Point pos_neu;
+            if(c < 0) {
+                v_neu   = ped->GetV() + result_acc[p] * deltaT;
+                pos_neu = ped->GetPos() + v_neu * deltaT;
+            } else {
+                v_neu   = subV[c];
+                pos_neu = subPos[c];
+                // SetPos() keeps the position at the beginning of the step as last position
+                JEllipse E = ped->GetEllipse();
+                E.SetCenter(startPos[c]);
+                ped->SetEllipse(E);
+            }
             //Jam is based on the current velocity
             if(v_neu.Norm() >= J_EPS_V) {
                 ped->ResetTimeInJam();
@@ -219,13 +316,121 @@ void GCFMModel::ComputeNextTimeStep(
             ped->SetPos(pos_neu);
             ped->SetV(v_neu);
             ped->SetPhiPed();
+            kinematics.Store(ped->GetKinematicsIndex(), *ped);
         }
-
     } //end parallel
+
+    std::vector<Pedestrian *> pedsToRemove;
+    for(std::size_t p = 0; p < nSize; ++p) {
+        if(toRemove[p]) {
+            pedsToRemove.push_back(allPeds[p]);
+        }
+    }
+    building->DeletePedestrians(pedsToRemove);
 }
 
 
-inline Point GCFMModel::ForceDriv(Pedestrian * ped, Room * room) const
+template <bool pairwise, bool wallField, bool floorfieldDirection>
+Point GCFMModel::Acceleration(
+    Building * building,
+    std::size_t p,
+    int thread,
+    PackedEllipses & neighbours,
+    std::vector<double> & distEff)
+{
+    AgentsKinematics & kinematics = building->GetKinematics();
+    Pedestrian * ped              = building->GetAllPedestrians()[p];
+    Room * room                   = ped->GetRoom();
+    SubRoom * subroom             = ped->GetSubRoom();
+    int debugPed                  = -10;
+
+    Point F_rep;
+
+    const std::size_t slot = ped->GetKinematicsIndex();
+    const Point p1         = kinematics.GetPos(slot);
+    const int uniqueRoomID = kinematics.GetUniqueRoomID(slot);
+    if(pairwise) {
+        _pairRanges[p] = {thread, _pairForces[thread].size(), 0};
+    }
+    // neighbour indices are slots in the kinematics store, both are filled from allPeds
+    neighbours.Clear();
+    building->GetNeighborhoodSearch().ForEachNeighbourIndex(p, [&](std::size_t j) {
+        //the pair is evaluated by the pedestrian with the smaller index
+        if(pairwise && j < p)
+            return;
+        Point p2      = kinematics.GetPos(j);
+        SubRoom * sb2 = kinematics._subRoom[j];
+        //only neighbours in the same subroom or in neighbour subrooms interact
+        if(uniqueRoomID != kinematics.GetUniqueRoomID(j) && !subroom->IsDirectlyConnectedWith(sb2))
+            return;
+        //the walls between them belong to one of their subrooms
+        bool ped_is_visible = building->IsVisible(p1, p2, subroom, sb2);
+        if(!ped_is_visible)
+            return;
+        neighbours.Add(kinematics._peds[j]->GetEllipse(), j);
+    }); //for peds
+
+    // the effective distances are the expensive part, all of them at once
+    neighbours.EffectiveDistances(ped->GetEllipse(), distEff);
+    for(std::size_t k = 0; k < neighbours.Size(); ++k) {
+        //          smax    dist_intpol_left      dist_intpol_right       dist_eff_max
+        //       ----|-------------|--------------------------|--------------|----
+        //       5   |     4       |            3             |      2       | 1
+
+        // If the pedestrian is outside the cutoff distance, the force is zero.
+        if(distEff[k] >= _distEffMaxPed)
+            continue;
+        const std::size_t j = neighbours.GetIndex(k);
+        Pedestrian * ped1   = kinematics._peds[j];
+        Point ep12;
+        if(!DirectionPed(ped->GetEllipse(), ped1->GetEllipse(), ep12))
+            continue;
+        if(pairwise) {
+            _pairForces[thread].push_back(
+                {p,
+                 j,
+                 ForceRepPed(ped, ped1, distEff[k], ep12),
+                 ForceRepPed(ped1, ped, distEff[k], ep12 * -1)});
+        } else {
+            F_rep = F_rep + ForceRepPed(ped, ped1, distEff[k], ep12);
+        }
+    }
+    if(pairwise) {
+        _pairRanges[p].end = _pairForces[thread].size();
+    }
+
+
+    //repulsive forces to the walls and transitions that are not my target
+    Point repwall = ForceRepRoom<wallField>(ped, subroom);
+    Point fd      = ForceDriv<floorfieldDirection>(ped, room);
+    Point acc     = (fd + F_rep + repwall) / ped->GetMass();
+
+    if(ped->GetID() == debugPed) {
+        printf(
+            "\nacc= %f %f, fd= %f, %f,  repPed = %f %f, repWall= %f, %f\n",
+            acc._x,
+            acc._y,
+            fd._x,
+            fd._y,
+            F_rep._x,
+            F_rep._y,
+            repwall._x,
+            repwall._y);
+    }
+
+    return acc;
+}
+
+int GCFMModel::SubSteps(const Point & acc, double deltaT) const
+{
+    const double subSteps = ceil(acc.Norm() * deltaT / MAX_SUBSTEP_DV);
+    if(!(subSteps > 1)) // also for a NaN acceleration
+        return 1;
+    return subSteps < _maxSubSteps ? static_cast<int>(subSteps) : _maxSubSteps;
+}
+
+template <bool floorfieldDirection>
+Point GCFMModel::ForceDriv(Pedestrian * ped, Room * room) const
 {
     const Point & target = _direction->GetTarget(room, ped);
     Point F_driv;
@@ -234,8 +439,7 @@ inline Point GCFMModel::ForceDriv(Pedestrian * ped, Room * room) const
     Point lastE0      = ped->GetLastE0();
     ped->SetLastE0(target - pos);
 
-    if((dynamic_cast<DirectionLocalFloorfield *>(_direction->GetDirectionStrategy().get())) ||
-       (dynamic_cast<DirectionSubLocalFloorfield *>(_direction->GetDirectionStrategy().get()))) {
+    if(floorfieldDirection) {
         if(dist > 50 * J_EPS_GOAL) {
             const Point & v0 = ped->GetV0(target);
             F_driv = ((v0 * ped->GetV0Norm() - ped->GetV()) * ped->GetMass()) / ped->GetTau();
@@ -254,50 +458,17 @@ inline Point GCFMModel::ForceDriv(Pedestrian * ped, Room * room) const
     return F_driv;
 }
 
-Point GCFMModel::ForceRepPed(Pedestrian * ped1, Pedestrian * ped2) const
+bool GCFMModel::DirectionPed(const JEllipse & E1, const JEllipse & E2, Point & ep12) const
 {
-    Point F_rep;
-    // x- and y-coordinate of the distance between p1 and p2
-    Point distp12     = ped2->GetPos() - ped1->GetPos();
-    const Point & vp1 = ped1->GetV(); // v Ped1
-    const Point & vp2 = ped2->GetV(); // v Ped2
-    Point ep12; // x- and y-coordinate of the normalized vector between p1 and p2
-    double tmp, tmp2;
-    double v_ij;
-    double K_ij;
-    double nom; //nominator of Frep
-    double px;  // hermite Interpolation value
-    const JEllipse & E1 = ped1->GetEllipse();
-    const JEllipse & E2 = ped2->GetEllipse();
-    double distsq;
-    double dist_eff = E1.EffectiveDistanceToEllipse(E2, &distsq);
-
-
-    //          smax    dist_intpol_left      dist_intpol_right       dist_eff_max
-    //       ----|-------------|--------------------------|--------------|----
-    //       5   |     4       |            3             |      2       | 1
-
-    // If the pedestrian is outside the cutoff distance, the force is zero.
-    if(dist_eff >= _distEffMaxPed) {
-        F_rep = Point(0.0, 0.0);
-        return F_rep;
-    }
-
     //%------- Free parameter --------------
     Point p1, p2; // "Normale" Koordinaten
-    double mindist;
-
 
     p1 = Point(E1.GetXp(), 0)
              .TransformToCartesianCoordinates(E1.GetCenter(), E1.GetCosPhi(), E1.GetSinPhi());
     p2 = Point(E2.GetXp(), 0)
              .TransformToCartesianCoordinates(E2.GetCenter(), E2.GetCosPhi(), E2.GetSinPhi());
-    distp12 = p2 - p1;
-    mindist = 0.5; //for performance reasons, it is assumed that this distance is about 50 cm
-    double dist_intpol_left  = mindist + _intp_widthPed;        // lower cut-off for Frep (modCFM)
-    double dist_intpol_right = _distEffMaxPed - _intp_widthPed; //upper cut-off for Frep (modCFM)
-    double smax              = mindist - _intp_widthPed;        //max overlapping
-    double f = 0.0f, f1 = 0.0f; //function value and its derivative at the interpolation point'
+    // x- and y-coordinate of the distance between p1 and p2
+    Point distp12 = p2 - p1;
 
     //todo: runtime normsquare?
     if(distp12.Norm() >= J_EPS) {
@@ -308,8 +479,32 @@ Point GCFMModel::ForceRepPed(Pedestrian * ped1, Pedestrian * ped2) const
             "Distance between two pedestrians is small ({}<{}). Force can not be calculated.",
             distp12.Norm(),
             J_EPS);
-        return F_rep; // Parameter values are not chosen wisely --> unrealistic overlaping ... ignore.
+        return false; // Parameter values are not chosen wisely --> unrealistic overlaping ... ignore.
     }
+    return true;
+}
+
+Point GCFMModel::ForceRepPed(
+    Pedestrian * ped1,
+    Pedestrian * ped2,
+    double dist_eff,
+    const Point & ep12) const
+{
+    Point F_rep;
+    const Point & vp1 = ped1->GetV(); // v Ped1
+    const Point & vp2 = ped2->GetV(); // v Ped2
+    double tmp, tmp2;
+    double v_ij;
+    double K_ij;
+    double nom; //nominator of Frep
+    double px;  // hermite Interpolation value
+    //for performance reasons, it is assumed that this distance is about 50 cm
+    double mindist           = 0.5;
+    double dist_intpol_left  = mindist + _intp_widthPed;        // lower cut-off for Frep (modCFM)
+    double dist_intpol_right = _distEffMaxPed - _intp_widthPed; //upper cut-off for Frep (modCFM)
+    double smax              = mindist - _intp_widthPed;        //max overlapping
+    double f = 0.0f, f1 = 0.0f; //function value and its derivative at the interpolation point'
+
     // calculate the parameter (whatever dist is)
     tmp  = (vp1 - vp2).ScalarProduct(ep12); // < v_ij , e_ij >
     v_ij = 0.5 * (tmp + fabs(tmp));
@@ -375,12 +570,21 @@ Point GCFMModel::ForceRepPed(Pedestrian * ped1, Pedestrian * ped2) const
  *   - Vektor(x,y) mit Summe aller abstoßenden Kräfte im SubRoom
  * */
 
-inline Point GCFMModel::ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const
+template <bool wallField>
+Point GCFMModel::ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const
 {
     Point f(0., 0.);
-    //first the walls
-    for(const auto & wall : subroom->GetAllWalls()) {
-        f += ForceRepWall(ped, wall);
+    // a subroom without a field, e.g. one created after Init(), falls back to all walls
+    const bool useField = wallField && subroom->GetWallDistanceField().IsBuilt();
+    if(useField) {
+        // the field holds the walls and the obstacle walls, only the close ones are evaluated
+        subroom->GetWallDistanceField().ForEachWallInCutoff(
+            ped->GetPos(), [&](const Line & wall) { f += ForceRepWall(ped, wall); });
+    } else {
+        //first the walls
+        for(const auto & wall : subroom->GetAllWalls()) {
+            f += ForceRepWall(ped, wall);
+        }
     }
     //then the obstacles
     for(const auto & obst : subroom->GetAllObstacles()) {
@@ -391,7 +595,7 @@ inline Point GCFMModel::ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const
                 subroom->GetRoomID(),
                 subroom->GetSubRoomID());
             exit(EXIT_FAILURE);
-        } else
+        } else if(!useField)
             for(const auto & wall : obst->GetAllWalls()) {
                 f += ForceRepWall(ped, wall);
             }
@@ -584,6 +788,16 @@ double GCFMModel::GetDistEffMaxWall() const
     return _distEffMaxWall;
 }
 
+bool GCFMModel::IsPairwiseForcePed() const
+{
+    return _pairwiseForcePed;
+}
+
+int GCFMModel::GetMaxSubSteps() const
+{
+    return _maxSubSteps;
+}
+
 std::string GCFMModel::GetDescription()
 {
     std::string rueck;
@@ -597,6 +811,12 @@ std::string GCFMModel::GetDescription()
     rueck.append(tmp);
     sprintf(tmp, "\t\tDistEffMax: \tPed: %f \tWall: %f\n", _distEffMaxPed, _distEffMaxWall);
     rueck.append(tmp);
+    sprintf(tmp, "\t\tCutoff: \tWall: %f\n", _wallCutoff);
+    rueck.append(tmp);
+    sprintf(tmp, "\t\tPairwise: \tPed: %s\n", _pairwiseForcePed ? "true" : "false");
+    rueck.append(tmp);
+    sprintf(tmp, "\t\tMax. substeps: \t%d\n", _maxSubSteps);
+    rueck.append(tmp);
 
     return rueck;
 }
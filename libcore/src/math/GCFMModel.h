@@ -29,9 +29,12 @@
 #include "OperationalModel.h"
 #include "geometry/Building.h"
 
+#include <cstddef>
 #include <vector>
 
 //forward declaration
+class JEllipse;
+class PackedEllipses;
 class Pedestrian;
 class DirectionManager;
 
@@ -56,7 +59,10 @@ public:
         double intp_widthped,
         double intp_widthwall,
         double maxfped,
-        double maxfwall);
+        double maxfwall,
+        double wallCutoff,
+        bool pairwiseForcePed = false,
+        int maxSubSteps       = 1);
     virtual ~GCFMModel(void);
 
     // Getter
@@ -69,6 +75,8 @@ public:
     double GetMaxFWall() const;
     double GetDistEffMaxPed() const;
     double GetDistEffMaxWall() const;
+    bool IsPairwiseForcePed() const;
+    int GetMaxSubSteps() const;
 
     /**
      * Compute the next simulation step
@@ -92,6 +100,71 @@ private:
     double _maxfWall;
     double _distEffMaxPed;  // maximal effective distance
     double _distEffMaxWall; // maximal effective distance
+    double _wallCutoff;     // walls farther away do not act on an agent, 0 for all walls
+    bool _pairwiseForcePed; // evaluate the geometry of each pair of pedestrians once
+    int _maxSubSteps;       // agents in contact are integrated with up to this many sub-steps
+
+    /// repulsion between the pedestrians ped1 and ped2, indices in GetAllPedestrians()
+    struct PairForce {
+        std::size_t ped1;
+        std::size_t ped2;
+        Point force12; // acting on ped1
+        Point force21; // acting on ped2
+    };
+    /// pairs of the pedestrians in _pairRanges[p].thread, from _pairRanges[p].begin to end
+    struct PairRange {
+        int thread;
+        std::size_t begin;
+        std::size_t end;
+    };
+    /// per thread the pairs it evaluated, kept between the steps to reuse the memory
+    std::vector<std::vector<PairForce>> _pairForces;
+    std::vector<PairRange> _pairRanges;
+
+    using ComputeStepFunction = void (GCFMModel::*)(double, double, Building *, int);
+    /// ComputeStep() for the policies of the simulation, selected in Init()
+    ComputeStepFunction _computeStep;
+
+    /**
+     * ComputeNextTimeStep() for fixed policies. They are known when the simulation starts, so the
+     * loop over the pedestrians does not branch on them.
+     * @tparam pairwise the geometry of each pair of pedestrians is evaluated once
+     * @tparam wallField the subrooms have wall distance fields, i.e. a wall cutoff is set
+     * @tparam floorfieldDirection the direction strategy is based on a local floor field
+     */
+    template <bool pairwise, bool wallField, bool floorfieldDirection>
+    void ComputeStep(double current, double deltaT, Building * building, int periodic);
+
+    /**
+     * Acceleration of a pedestrian by the driving force and the repulsion of the pedestrians,
+     * the walls and the closed doors.
+     * @param building the geometry object
+     * @param p index of the pedestrian in Building::GetAllPedestrians()
+     * @param thread the calling thread, in the pairwise mode it keeps the pair forces
+     * @param neighbours buffer for the ellipses of the neighbours
+     * @param distEff buffer for the effective distances to the neighbours
+     * @tparam pairwise only the pairs with the neighbours of larger index are evaluated, their
+     * forces are stored in _pairForces and not part of the result
+     *
+     * @return Point
+     */
+    template <bool pairwise, bool wallField, bool floorfieldDirection>
+    Point Acceleration(
+        Building * building,
+        std::size_t p,
+        int thread,
+        PackedEllipses & neighbours,
+        std::vector<double> & distEff);
+
+    /**
+     * Number of sub-steps that keep the change of the velocity in each sub-step small. An agent
+     * in contact is pushed hard by its neighbours or a wall and needs more than one.
+     * @param acc acceleration of the agent at the beginning of the step
+     * @param deltaT the time step
+     *
+     * @return between 1 and _maxSubSteps
+     */
+    int SubSteps(const Point & acc, double deltaT) const;
 
     // Private Funktionen
     /**
@@ -99,29 +172,53 @@ private:
      *
      * @param ped Pointer to Pedestrians
      * @param room Pointer to Room
+     * @tparam floorfieldDirection the direction strategy is based on a local floor field
      *
      * @return Point
      */
+    template <bool floorfieldDirection>
     Point ForceDriv(Pedestrian * ped, Room * room) const;
     /**
-     * Repulsive force between two pedestrians ped1 and ped2 according to
-     * the Generalized Centrifugal Force Model (chraibi2010a)
+     * Repulsive force of ped2 acting on ped1 according to the Generalized Centrifugal Force Model
+     * (chraibi2010a). The geometry of the pair is computed beforehand, it is the same for ped1 and
+     * ped2 with the direction reversed.
+     * @see PackedEllipses::EffectiveDistances
+     * @see DirectionPed
      *
      * @param ped1 Pointer to Pedestrian: First pedestrian
      * @param ped2 Pointer to Pedestrian: Second pedestrian
+     * @param dist_eff effective distance between the ellipses, smaller than the cutoff
+     * @param ep12 normalized vector from ped1 to ped2
      *
      * @return Point
      */
-    Point ForceRepPed(Pedestrian * ped1, Pedestrian * ped2) const;
+    Point ForceRepPed(
+        Pedestrian * ped1,
+        Pedestrian * ped2,
+        double dist_eff,
+        const Point & ep12) const;
+    /**
+     * Direction of the repulsion between two pedestrians, from the first to the second ellipse.
+     *
+     * @param E1 ellipse of the first pedestrian
+     * @param E2 ellipse of the second pedestrian
+     * @param ep12 receives the normalized vector from the first to the second pedestrian
+     *
+     * @return false if the direction can not be calculated, then there is no force
+     */
+    bool DirectionPed(const JEllipse & E1, const JEllipse & E2, Point & ep12) const;
     /**
      * Repulsive force acting on pedestrian <ped> from the walls in
-     * <subroom>. The sum of all repulsive forces of the walls in <subroom> is calculated
+     * <subroom>. The sum of all repulsive forces of the walls in <subroom> is calculated. With a
+     * wall cutoff only the walls within the cutoff are evaluated, see WallDistanceField.
      * @see ForceRepWall
      * @param ped Pointer to Pedestrian
      * @param subroom Pointer to SubRoom
+     * @tparam wallField the subrooms have wall distance fields
      *
      * @return
      */
+    template <bool wallField>
     Point ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const;
     Point ForceRepWall(Pedestrian * ped, const Line & l) const;
     Point ForceRepStatPoint(Pedestrian * ped, const Point & p, double l, double vn) const;
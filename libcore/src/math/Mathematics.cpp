@@ -26,7 +26,10 @@
  **/
 #include "Mathematics.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 // ok that is not perfect. For a profound discussion see http://randomascii.wordpress.com/2012/02/25/comparing-floating-point-numbers-2012-edition/
 bool almostEqual(double a, double b, double eps)
@@ -70,6 +73,24 @@ double hermite_interp(double t, double x1, double x2, double y1, double y2, doub
     return left + right;
 }
 
+double FastExp(double x)
+{
+    x = std::min(std::max(x, -700.), 700.);
+    // adding 1.5 * 2^52 rounds to an integer, which ends up in the low bits of the mantissa
+    const double shift   = 6755399441055744.;
+    const double shifted = x * 1.4426950408889634 + shift; // log2(e)
+    const double n       = shifted - shift;
+    const double r       = x - n * 0.6931471805599453; // ln(2)
+    const double p =
+        1. + r * (1. + r * (1. / 2 + r * (1. / 6 + r * (1. / 24 + r * (1. / 120)))));
+    // 2^n: the biased exponent n + 1023 shifted into the exponent bits
+    std::uint64_t bits;
+    std::memcpy(&bits, &shifted, sizeof(bits));
+    bits = (bits + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
 
 /* Principal cubic root of a complex number */
 std::complex<double> c_cbrt(std::complex<double> x)
@@ -37,4 +37,18 @@ double sign(double x);
 double sigmoid(double a, double b, double x);
 double hermite_interp(double x, double x1, double x2, double y1, double y2, double dy1, double dy2);
 
+/**
+ * Approximation of exp(x) for the fast-math mode of the models.
+ *
+ * x is split into n ln(2) + r with an integer n and |r| <= ln(2)/2, exp(r) is replaced by its
+ * Taylor polynomial of degree 5 and 2^n is written into the exponent bits. The relative error is
+ * below FAST_EXP_MAX_REL_ERROR for x in [-700, 700], x outside is clamped to this range.
+ * @param x exponent
+ * @return approximation of exp(x)
+ */
+double FastExp(double x);
+
+/// maximum relative error of FastExp(), (ln(2)/2)^6 / 6! / exp(-ln(2)/2) rounded up
+constexpr double FAST_EXP_MAX_REL_ERROR = 3.5e-6;
+
 std::complex<double> c_cbrt(std::complex<double> x);
@@ -29,6 +29,30 @@
  **/
 #include "OperationalModel.h"
 
+#include "direction/DirectionManager.h"
+#include "direction/walking/DirectionStrategy.h"
+#include "geometry/Building.h"
+#include "neighborhood/NeighborhoodSearch.h"
+
+namespace
+{
+/// minimal number of pedestrians of a work item, small enough to keep all threads busy
+constexpr std::size_t WORK_ITEM_SIZE = 32;
+} // namespace
+
 OperationalModel::OperationalModel() {}
 
 OperationalModel::~OperationalModel() {}
+
+std::size_t OperationalModel::UpdateWorkItems(const Building & building)
+{
+    building.GetNeighborhoodSearch().GetCellBlocks(WORK_ITEM_SIZE, _workOrder, _workItemStart);
+    return _workItemStart.size() - 1;
+}
+
+bool OperationalModel::IsFloorfieldDirection() const
+{
+    const DirectionStrategy * strategy = _direction->GetDirectionStrategy().get();
+    return dynamic_cast<const DirectionLocalFloorfield *>(strategy) ||
+           dynamic_cast<const DirectionSubLocalFloorfield *>(strategy);
+}
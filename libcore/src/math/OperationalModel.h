@@ -37,8 +37,10 @@
 /** @} */ // end of group
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 class Building;
 class DirectionManager;
@@ -49,6 +51,27 @@ protected:
     // define the strategy for crossing a door (used for calculating the driving force)
     std::shared_ptr<DirectionManager> _direction;
 
+    /// pedestrian indices sorted by cell, work item w is [_workItemStart[w], _workItemStart[w + 1])
+    std::vector<std::size_t> _workOrder;
+    std::vector<std::size_t> _workItemStart;
+
+    /**
+      * Splits the pedestrians of the building into work items of neighbouring cells. The cost of
+      * a pedestrian depends on the crowd around it, so the work items are scheduled dynamically
+      * instead of giving each thread an equal range of pedestrians.
+      * @param building, the building whose neighbourhood search is up to date
+      * @return the number of work items
+      */
+    std::size_t UpdateWorkItems(const Building & building);
+
+    /**
+      * The models steer differently when the direction strategy is based on a local floor field.
+      * The strategy does not change during a simulation, so the models ask once in Init().
+      * @return true if the direction strategy is DirectionLocalFloorfield or
+      * DirectionSubLocalFloorfield
+      */
+    bool IsFloorfieldDirection() const;
+
 public:
     /**
       * Constructor
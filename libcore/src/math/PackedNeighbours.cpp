@@ -0,0 +1,278 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "PackedNeighbours.h"
+
+#include "Mathematics.h"
+#include "general/Macros.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/*
+ * Replaces the values by FastExp() of them. The lanes repeat its operations, the 64 bit integer
+ * arithmetic for the exponent bits needs AVX2 for four lanes.
+ */
+void FastExps(std::vector<double> & values)
+{
+    const std::size_t size = values.size();
+    std::size_t i          = 0;
+#if defined(__AVX2__)
+    const __m256d lower = _mm256_set1_pd(-700.);
+    const __m256d upper = _mm256_set1_pd(700.);
+    const __m256d shift = _mm256_set1_pd(6755399441055744.);
+    const __m256d log2e = _mm256_set1_pd(1.4426950408889634);
+    const __m256d ln2   = _mm256_set1_pd(0.6931471805599453);
+    const __m256d one   = _mm256_set1_pd(1.);
+    const __m256d c2    = _mm256_set1_pd(1. / 2);
+    const __m256d c3    = _mm256_set1_pd(1. / 6);
+    const __m256d c4    = _mm256_set1_pd(1. / 24);
+    const __m256d c5    = _mm256_set1_pd(1. / 120);
+    const __m256i bias  = _mm256_set1_epi64x(1023);
+    for(; i + 4 <= size; i += 4) {
+        const __m256d value   = _mm256_loadu_pd(&values[i]);
+        const __m256d x       = _mm256_min_pd(_mm256_max_pd(value, lower), upper);
+        const __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, log2e), shift);
+        const __m256d n       = _mm256_sub_pd(shifted, shift);
+        const __m256d r       = _mm256_sub_pd(x, _mm256_mul_pd(n, ln2));
+        __m256d p             = _mm256_add_pd(c4, _mm256_mul_pd(r, c5));
+        p                     = _mm256_add_pd(c3, _mm256_mul_pd(r, p));
+        p                     = _mm256_add_pd(c2, _mm256_mul_pd(r, p));
+        p                     = _mm256_add_pd(one, _mm256_mul_pd(r, p));
+        p                     = _mm256_add_pd(one, _mm256_mul_pd(r, p));
+
+        // 2^n from the exponent bits, as in FastExp()
+        const __m256i exponent = _mm256_add_epi64(_mm256_castpd_si256(shifted), bias);
+        const __m256d scale    = _mm256_castsi256_pd(_mm256_slli_epi64(exponent, 52));
+        _mm256_storeu_pd(&values[i], _mm256_mul_pd(p, scale));
+    }
+#elif defined(__SSE2__)
+    const __m128d lower = _mm_set1_pd(-700.);
+    const __m128d upper = _mm_set1_pd(700.);
+    const __m128d shift = _mm_set1_pd(6755399441055744.);
+    const __m128d log2e = _mm_set1_pd(1.4426950408889634);
+    const __m128d ln2   = _mm_set1_pd(0.6931471805599453);
+    const __m128d one   = _mm_set1_pd(1.);
+    const __m128d c2    = _mm_set1_pd(1. / 2);
+    const __m128d c3    = _mm_set1_pd(1. / 6);
+    const __m128d c4    = _mm_set1_pd(1. / 24);
+    const __m128d c5    = _mm_set1_pd(1. / 120);
+    const __m128i bias  = _mm_set1_epi64x(1023);
+    for(; i + 2 <= size; i += 2) {
+        const __m128d x       = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(&values[i]), lower), upper);
+        const __m128d shifted = _mm_add_pd(_mm_mul_pd(x, log2e), shift);
+        const __m128d n       = _mm_sub_pd(shifted, shift);
+        const __m128d r       = _mm_sub_pd(x, _mm_mul_pd(n, ln2));
+        __m128d p             = _mm_add_pd(c4, _mm_mul_pd(r, c5));
+        p                     = _mm_add_pd(c3, _mm_mul_pd(r, p));
+        p                     = _mm_add_pd(c2, _mm_mul_pd(r, p));
+        p                     = _mm_add_pd(one, _mm_mul_pd(r, p));
+        p                     = _mm_add_pd(one, _mm_mul_pd(r, p));
+
+        // 2^n from the exponent bits, as in FastExp()
+        const __m128i exponent = _mm_add_epi64(_mm_castpd_si128(shifted), bias);
+        const __m128d scale    = _mm_castsi128_pd(_mm_slli_epi64(exponent, 52));
+        _mm_storeu_pd(&values[i], _mm_mul_pd(p, scale));
+    }
+#endif
+    for(; i < size; ++i) {
+        values[i] = FastExp(values[i]);
+    }
+}
+} // namespace
+
+void PackedNeighbours::Add(const Point & offset, bool repulsive, std::size_t index)
+{
+    _dx.push_back(offset._x);
+    _dy.push_back(offset._y);
+    _repulsive.push_back(repulsive);
+    _index.push_back(index);
+}
+
+void PackedNeighbours::Clear()
+{
+    _dx.clear();
+    _dy.clear();
+    _repulsive.clear();
+    _index.clear();
+    _distance.clear();
+    _ex.clear();
+    _ey.clear();
+    _strength.clear();
+}
+
+/*
+ * The lanes repeat the operations of Point::Norm() and Point::Normalized() in the same order, so
+ * the distances and unit vectors are the same as in the scalar code. There is no vector exp, the
+ * exponentials are evaluated one by one in the second loop, unless FastExp() is requested.
+ */
+Point PackedNeighbours::SumRepulsion(double l, double a, double D, bool fastExp)
+{
+    const std::size_t size = _dx.size();
+    _distance.resize(size);
+    _ex.resize(size);
+    _ey.resize(size);
+    _strength.resize(size);
+
+    std::size_t i = 0;
+#if defined(__AVX__)
+    const __m256d eps  = _mm256_set1_pd(J_EPS);
+    const __m256d len  = _mm256_set1_pd(l);
+    const __m256d span = _mm256_set1_pd(D);
+    for(; i + 4 <= size; i += 4) {
+        // Point::Normalized() returns (0, 0) for a norm up to J_EPS
+        const __m256d dx    = _mm256_loadu_pd(&_dx[i]);
+        const __m256d dy    = _mm256_loadu_pd(&_dy[i]);
+        const __m256d dd    = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        const __m256d d     = _mm256_sqrt_pd(dd);
+        const __m256d valid = _mm256_cmp_pd(d, eps, _CMP_GT_OQ);
+        _mm256_storeu_pd(&_distance[i], d);
+        _mm256_storeu_pd(&_ex[i], _mm256_and_pd(valid, _mm256_div_pd(dx, d)));
+        _mm256_storeu_pd(&_ey[i], _mm256_and_pd(valid, _mm256_div_pd(dy, d)));
+        _mm256_storeu_pd(&_strength[i], _mm256_div_pd(_mm256_sub_pd(len, d), span));
+    }
+#elif defined(__SSE2__)
+    const __m128d eps  = _mm_set1_pd(J_EPS);
+    const __m128d len  = _mm_set1_pd(l);
+    const __m128d span = _mm_set1_pd(D);
+    for(; i + 2 <= size; i += 2) {
+        const __m128d dx    = _mm_loadu_pd(&_dx[i]);
+        const __m128d dy    = _mm_loadu_pd(&_dy[i]);
+        const __m128d dd    = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        const __m128d d     = _mm_sqrt_pd(dd);
+        const __m128d valid = _mm_cmpgt_pd(d, eps);
+        _mm_storeu_pd(&_distance[i], d);
+        _mm_storeu_pd(&_ex[i], _mm_and_pd(valid, _mm_div_pd(dx, d)));
+        _mm_storeu_pd(&_ey[i], _mm_and_pd(valid, _mm_div_pd(dy, d)));
+        _mm_storeu_pd(&_strength[i], _mm_div_pd(_mm_sub_pd(len, d), span));
+    }
+#endif
+    for(; i < size; ++i) {
+        const Point offset(_dx[i], _dy[i]);
+        const Point e = offset.Normalized();
+        _distance[i]  = offset.Norm();
+        _ex[i]        = e._x;
+        _ey[i]        = e._y;
+        _strength[i]  = (l - _distance[i]) / D;
+    }
+
+    if(fastExp) {
+        FastExps(_strength);
+    }
+
+    Point sum(0., 0.);
+    for(i = 0; i < size; ++i) {
+        if(_repulsive[i]) {
+            const double R = -a * (fastExp ? _strength[i] : exp(_strength[i]));
+            sum += Point(_ex[i] * R, _ey[i] * R);
+        }
+    }
+    return sum;
+}
+
+/*
+ * Neighbours that are not in front get the spacing FLT_MAX, the minimum does not depend on the
+ * order, so the lanes are reduced at the end.
+ */
+double PackedNeighbours::MinSpacing(const Point & direction, double l, double noNeighbour) const
+{
+    const std::size_t size = _dx.size();
+    // theta = pi/2
+    const Point normal = direction.Rotate(0, 1);
+    double spacing     = noNeighbour;
+
+    std::size_t i = 0;
+#if defined(__AVX__)
+    const __m256d ex      = _mm256_set1_pd(direction._x);
+    const __m256d ey      = _mm256_set1_pd(direction._y);
+    const __m256d nx      = _mm256_set1_pd(normal._x);
+    const __m256d ny      = _mm256_set1_pd(normal._y);
+    const __m256d len     = _mm256_set1_pd(l);
+    const __m256d zero    = _mm256_setzero_pd();
+    const __m256d far     = _mm256_set1_pd(FLT_MAX);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    __m256d spacings      = _mm256_set1_pd(noNeighbour);
+    for(; i + 4 <= size; i += 4) {
+        const __m256d ejx        = _mm256_loadu_pd(&_ex[i]);
+        const __m256d ejy        = _mm256_loadu_pd(&_ey[i]);
+        const __m256d d          = _mm256_loadu_pd(&_distance[i]);
+        const __m256d condition1 = _mm256_add_pd(_mm256_mul_pd(ex, ejx), _mm256_mul_pd(ey, ejy));
+        const __m256d condition2 = _mm256_add_pd(_mm256_mul_pd(nx, ejx), _mm256_mul_pd(ny, ejy));
+        const __m256d inFront    = _mm256_and_pd(
+            _mm256_cmp_pd(condition1, zero, _CMP_GE_OQ),
+            _mm256_cmp_pd(_mm256_and_pd(absMask, condition2), _mm256_div_pd(len, d), _CMP_LE_OQ));
+
+        spacings = _mm256_min_pd(spacings, _mm256_blendv_pd(far, d, inFront));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, spacings);
+    spacing = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+#elif defined(__SSE2__)
+    const __m128d ex      = _mm_set1_pd(direction._x);
+    const __m128d ey      = _mm_set1_pd(direction._y);
+    const __m128d nx      = _mm_set1_pd(normal._x);
+    const __m128d ny      = _mm_set1_pd(normal._y);
+    const __m128d len     = _mm_set1_pd(l);
+    const __m128d zero    = _mm_setzero_pd();
+    const __m128d far     = _mm_set1_pd(FLT_MAX);
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    __m128d spacings      = _mm_set1_pd(noNeighbour);
+    for(; i + 2 <= size; i += 2) {
+        const __m128d ejx        = _mm_loadu_pd(&_ex[i]);
+        const __m128d ejy        = _mm_loadu_pd(&_ey[i]);
+        const __m128d d          = _mm_loadu_pd(&_distance[i]);
+        const __m128d condition1 = _mm_add_pd(_mm_mul_pd(ex, ejx), _mm_mul_pd(ey, ejy));
+        const __m128d condition2 = _mm_add_pd(_mm_mul_pd(nx, ejx), _mm_mul_pd(ny, ejy));
+        const __m128d inFront    = _mm_and_pd(
+            _mm_cmpge_pd(condition1, zero),
+            _mm_cmple_pd(_mm_and_pd(absMask, condition2), _mm_div_pd(len, d)));
+        // no blend in SSE2
+        const __m128d candidate = _mm_or_pd(_mm_and_pd(inFront, d), _mm_andnot_pd(inFront, far));
+
+        spacings = _mm_min_pd(spacings, candidate);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, spacings);
+    spacing = std::min(lanes[0], lanes[1]);
+#endif
+    for(; i < size; ++i) {
+        const Point ej(_ex[i], _ey[i]);
+        const double condition1 = direction.ScalarProduct(ej);
+        const double condition2 = std::abs(normal.ScalarProduct(ej));
+        if(condition1 >= 0 && condition2 <= l / _distance[i]) {
+            spacing = std::min(spacing, _distance[i]);
+        }
+    }
+    return spacing;
+}
+
+std::size_t PackedNeighbours::FindCloserThan(double distance) const
+{
+    auto closer = std::find_if(
+        std::begin(_distance), std::end(_distance), [distance](double d) { return d < distance; });
+    return closer - std::begin(_distance);
+}
@@ -0,0 +1,113 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Neighbours of one pedestrian stored as structure of arrays for the velocity model kernel.
+ *
+ **/
+#pragma once
+
+#include "geometry/Point.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Neighbours of one pedestrian stored as structure of arrays.
+ *
+ * The velocity model needs the repulsion of the visible neighbours and the smallest spacing to
+ * the neighbours in walking direction. The walking direction depends on the repulsion, so the
+ * neighbours are traversed twice: SumRepulsion() computes the distances and unit vectors and
+ * MinSpacing() reuses them. Both work on several neighbours at once with AVX or SSE2 when the
+ * compiler targets them and one by one otherwise, the results are the same as the scalar
+ * formulas of the model. The buffers keep their capacity, so one object per thread serves all
+ * pedestrians without allocations.
+ */
+class PackedNeighbours
+{
+private:
+    /// position of the neighbour relative to the pedestrian
+    std::vector<double> _dx;
+    std::vector<double> _dy;
+    /// true if the neighbour repels the pedestrian, false if it only counts for the spacing
+    std::vector<char> _repulsive;
+    /// index of the neighbour given to Add()
+    std::vector<std::size_t> _index;
+    /// filled by SumRepulsion(): distance, unit vector to the neighbour and repulsion term
+    std::vector<double> _distance;
+    std::vector<double> _ex;
+    std::vector<double> _ey;
+    std::vector<double> _strength;
+
+public:
+    /**
+     * Appends a neighbour.
+     * @param offset position of the neighbour relative to the pedestrian
+     * @param repulsive true if the neighbour repels the pedestrian, i.e. it is visible
+     * @param index index of the neighbour, e.g. its slot in the AgentsKinematics
+     */
+    void Add(const Point & offset, bool repulsive, std::size_t index);
+
+    /**
+     * Removes all neighbours, the capacity is kept.
+     */
+    void Clear();
+
+    /**
+     * @return the number of neighbours
+     */
+    std::size_t Size() const { return _dx.size(); }
+
+    /**
+     * Sums the repulsion \f$ -a \exp((l - d_j) / D) e_j \f$ of the repulsive neighbours, where
+     * \f$ d_j \f$ is the distance and \f$ e_j \f$ the unit vector to neighbour j. The terms are
+     * added in the order of the neighbours. Computes the distances used by MinSpacing() and
+     * FindCloserThan().
+     * @param l length of the pedestrian, twice its radius
+     * @param a strength of the repulsion
+     * @param D range of the repulsion
+     * @param fastExp true to approximate exp by FastExp()
+     * @return the sum of the repulsions
+     */
+    Point SumRepulsion(double l, double a, double D, bool fastExp = false);
+
+    /**
+     * Returns the smallest distance to a neighbour in front of the pedestrian. Neighbour j is in
+     * front if \f$ \langle e, e_j \rangle \ge 0 \f$ and \f$ |\langle e^\perp, e_j \rangle| \le
+     * l / d_j \f$. Needs the distances of SumRepulsion().
+     * @param direction walking direction e of the pedestrian
+     * @param l length of the pedestrian, twice its radius
+     * @param noNeighbour spacing if no neighbour is in front
+     * @return the smallest spacing
+     */
+    double MinSpacing(const Point & direction, double l, double noNeighbour) const;
+
+    /**
+     * Needs the distances of SumRepulsion().
+     * @param distance minimal distance
+     * @return index of the first neighbour closer than distance, Size() if there is none
+     */
+    std::size_t FindCloserThan(double distance) const;
+
+    /**
+     * @param n position of the neighbour in this object
+     * @return the index given to Add()
+     */
+    std::size_t GetIndex(std::size_t n) const { return _index[n]; }
+};
@@ -28,11 +28,14 @@
  **/
 #include "VelocityModel.h"
 
+#include "Mathematics.h"
+#include "PackedNeighbours.h"
 #include "direction/walking/DirectionStrategy.h"
 #include "general/OpenMP.h"
 #include "geometry/SubRoom.h"
 #include "geometry/Wall.h"
 #include "neighborhood/NeighborhoodSearch.h"
+#include "pedestrian/AgentsKinematics.h"
 #include "pedestrian/Pedestrian.h"
 
 #include <Logger.h>
@@ -46,7 +49,9 @@ VelocityModel::VelocityModel(
     double aped,
     double Dped,
     double awall,
-    double Dwall)
+    double Dwall,
+    double wallCutoff,
+    bool fastMath)
 {
     _direction = dir;
     // Force_rep_PED Parameter
@@ -55,6 +60,10 @@ VelocityModel::VelocityModel(
     // Force_rep_WALL Parameter
     _aWall = awall;
     _DWall = Dwall;
+    // only walls within the cutoff act on an agent
+    _wallCutoff  = wallCutoff;
+    _fastMath    = fastMath;
+    _computeStep = nullptr; // selected in Init()
 }
 
 
@@ -63,6 +72,22 @@ VelocityModel::~VelocityModel() {}
 bool VelocityModel::Init(Building * building)
 {
     _direction->Init(building);
+    if(_wallCutoff > 0) {
+        building->InitWallDistanceFields(_wallCutoff);
+    }
+
+    // all combinations of the policies, [periodic][wallField][floorfieldDirection]
+    static const ComputeStepFunction steps[2][2][2] = {
+        {{&VelocityModel::ComputeStep<false, false, false>,
+          &VelocityModel::ComputeStep<false, false, true>},
+         {&VelocityModel::ComputeStep<false, true, false>,
+          &VelocityModel::ComputeStep<false, true, true>}},
+        {{&VelocityModel::ComputeStep<true, false, false>,
+          &VelocityModel::ComputeStep<true, false, true>},
+         {&VelocityModel::ComputeStep<true, true, false>,
+          &VelocityModel::ComputeStep<true, true, true>}}};
+    const bool periodic = building->GetConfig()->IsPeriodic();
+    _computeStep        = steps[periodic][_wallCutoff > 0][IsFloorfieldDirection()];
 
     const std::vector<Pedestrian *> & allPeds = building->GetAllPedestrians();
     size_t peds_size                          = allPeds.size();
@@ -124,147 +149,142 @@ void VelocityModel::ComputeNextTimeStep(
     double current,
     double deltaT,
     Building * building,
-    int periodic)
+    int /*periodic*/)
+{
+    (this->*_computeStep)(current, deltaT, building);
+}
+
+template <bool periodic, bool wallField, bool floorfieldDirection>
+void VelocityModel::ComputeStep(double current, double deltaT, Building * building)
 {
     // collect all pedestrians in the simulation.
     const std::vector<Pedestrian *> & allPeds = building->GetAllPedestrians();
-    std::vector<Pedestrian *> pedsToRemove;
-    pedsToRemove.reserve(500);
-    unsigned long nSize;
-    nSize = allPeds.size();
+    AgentsKinematics & kinematics             = building->GetKinematics();
 
-    int nThreads = omp_get_max_threads();
+    const std::size_t nSize = allPeds.size();
 
-    int partSize;
-    partSize = ((int) nSize > nThreads) ? (int) (nSize / nThreads) : (int) nSize;
-    if(partSize == (int) nSize)
+    int nThreads = omp_get_max_threads();
+    if((int) nSize <= nThreads)
         nThreads = 1; // not worthy to parallelize
 
+    // the work items are blocks of neighbouring cells, crowded blocks take longer than empty ones
+    const std::size_t nWorkItems = UpdateWorkItems(*building);
+    std::vector<Point> result_acc(nSize);
+    // flags instead of a critical section around a shared vector
+    std::vector<char> toRemove(nSize, false);
 
-//TODO richtig parallelisieren!
 #pragma omp parallel default(shared) num_threads(nThreads)
     {
-        std::vector<Point> result_acc = std::vector<Point>();
-        result_acc.reserve(nSize);
-        std::vector<my_pair> spacings = std::vector<my_pair>();
-        spacings.reserve(nSize);             // larger than needed
-        spacings.push_back(my_pair(100, 1)); // in case there are no neighbors
-        const int threadID = omp_get_thread_num();
-
-        int start = threadID * partSize;
-        int end;
-        end = (threadID < nThreads - 1) ? (threadID + 1) * partSize - 1 : (int) (nSize - 1);
-        for(int p = start; p <= end; ++p) {
-            Pedestrian * ped  = allPeds[p];
-            Room * room       = building->GetRoom(ped->GetRoomID());
-            SubRoom * subroom = room->GetSubRoom(ped->GetSubRoomID());
-            Point repPed      = Point(0, 0);
-            std::vector<Pedestrian *> neighbours =
-                building->GetNeighborhoodSearch().GetNeighbourhood(ped);
-
-            int size = (int) neighbours.size();
-            for(int i = 0; i < size; i++) {
-                Pedestrian * ped1 = neighbours[i];
-                //if they are in the same subroom
-                Point p1 = ped->GetPos();
-
-                Point p2 = ped1->GetPos();
-                //subrooms to consider when looking for neighbour for the 3d visibility
-                std::vector<SubRoom *> emptyVector;
-                emptyVector.push_back(subroom);
-                emptyVector.push_back(
-                    building->GetRoom(ped1->GetRoomID())->GetSubRoom(ped1->GetSubRoomID()));
-                bool isVisible = building->IsVisible(p1, p2, emptyVector, false);
-                if(!isVisible)
-                    continue;
-                if(ped->GetUniqueRoomID() == ped1->GetUniqueRoomID()) {
-                    repPed += ForceRepPed(ped, ped1, periodic);
-                } else {
-                    // or in neighbour subrooms
-                    SubRoom * sb2 =
-                        building->GetRoom(ped1->GetRoomID())->GetSubRoom(ped1->GetSubRoomID());
-                    if(subroom->IsDirectlyConnectedWith(sb2)) {
-                        repPed += ForceRepPed(ped, ped1, periodic);
-                    }
+        // one buffer per thread, it keeps its capacity from one pedestrian to the next
+        PackedNeighbours neighbours;
+
+#pragma omp for schedule(dynamic)
+        for(std::size_t w = 0; w < nWorkItems; ++w) {
+            for(std::size_t n = _workItemStart[w]; n < _workItemStart[w + 1]; ++n) {
+                const std::size_t p = _workOrder[n];
+
+                Pedestrian * ped  = allPeds[p];
+                Room * room       = kinematics._room[p];
+                SubRoom * subroom = kinematics._subRoom[p];
+
+                const Point p1         = kinematics.GetPos(p);
+                const int uniqueRoomID = kinematics.GetUniqueRoomID(p);
+                const double l         = 2 * kinematics._radius[p];
+
+                // the neighbourhood search and the kinematics store are both filled from allPeds,
+                // so the neighbour indices are slots in the store
+                int size = 0;
+                neighbours.Clear();
+                building->GetNeighborhoodSearch().ForEachNeighbourIndex(p, [&](std::size_t j) {
+                    ++size;
+                    //subrooms to consider when looking for neighbour for the 3d visibility
+                    SubRoom * sb2 = kinematics._subRoom[j];
+                    //only neighbours in the same subroom or in neighbour subrooms interact, the
+                    //cheap check comes first
+                    if(uniqueRoomID != kinematics.GetUniqueRoomID(j) &&
+                       !subroom->IsDirectlyConnectedWith(sb2))
+                        return;
+                    //all of them count for the spacing, only the visible ones repel
+                    bool isVisible = building->IsVisible(p1, kinematics.GetPos(j), subroom, sb2);
+                    neighbours.Add(GetOffset<periodic>(kinematics, p, j), isVisible, j);
+                });
+                Point repPed = neighbours.SumRepulsion(l, _aPed, _DPed, _fastMath);
+
+                const std::size_t tooClose = neighbours.FindCloserThan(J_EPS);
+                if(tooClose < neighbours.Size()) {
+                    const std::size_t j = neighbours.GetIndex(tooClose);
+                    LOG_ERROR(
+                        "VelocityModel::ComputeNextTimeStep() ep12 can not be calculated! "
+                        "Pedestrians are too near to each other. Adjust <a> value in force_ped to "
+                        "counter this. Affected pedestrians ped1 {:d} at ({:f},{:f}) and ped2 {:d} "
+                        "at ({:f}, {:f})",
+                        kinematics._id[p],
+                        kinematics._x[p],
+                        kinematics._y[p],
+                        kinematics._id[j],
+                        kinematics._x[j],
+                        kinematics._y[j]);
+                    exit(EXIT_FAILURE); //TODO: quick and dirty fix for issue #158
+                                        // (sometimes sources create peds on the same location)
                 }
-            } // for i
-            //repulsive forces to walls and closed transitions that are not my target
-            Point repWall = ForceRepRoom(allPeds[p], subroom);
-
-            // calculate new direction ei according to (6)
-            Point direction = e0(ped, room) + repPed + repWall;
-            for(int i = 0; i < size; i++) {
-                Pedestrian * ped1 = neighbours[i];
-                // calculate spacing
-                // my_pair spacing_winkel = GetSpacing(ped, ped1);
-                if(ped->GetUniqueRoomID() == ped1->GetUniqueRoomID()) {
-                    spacings.push_back(GetSpacing(ped, ped1, direction, periodic));
-                } else {
-                    // or in neighbour subrooms
-                    SubRoom * sb2 =
-                        building->GetRoom(ped1->GetRoomID())->GetSubRoom(ped1->GetSubRoomID());
-                    if(subroom->IsDirectlyConnectedWith(sb2)) {
-                        spacings.push_back(GetSpacing(ped, ped1, direction, periodic));
-                    }
+                //repulsive forces to walls and closed transitions that are not my target
+                Point repWall = ForceRepRoom<wallField>(allPeds[p], subroom);
+
+                // calculate new direction ei according to (6)
+                Point direction = e0<floorfieldDirection>(ped, room) + repPed + repWall;
+                // calculate min spacing, 100 in case there are no neighbours in front
+                double spacing = neighbours.MinSpacing(direction, l, 100);
+                //TODO get spacing to walls
+                //TODO update direction every DT?
+
+                //============================================================
+                // TODO: Hack for Head on situations: ped1 x ------> | <------- x ped2
+                if(0 && direction.NormSquare() < 0.5) {
+                    double pi_half = 1.57079663;
+                    double alpha   = pi_half * exp(-spacing);
+                    direction      =
+                        e0<floorfieldDirection>(ped, room).Rotate(cos(alpha), sin(alpha));
+                    printf(
+                        "\nRotate %f, %f, norm = %f alpha = %f, spacing = %f\n",
+                        direction._x,
+                        direction._y,
+                        direction.NormSquare(),
+                        alpha,
+                        spacing);
+                    getc(stdin);
+                }
+                //============================================================
+                result_acc[p] = direction.Normalized() * OptimalSpeed(ped, spacing);
+
+                // stuck peds get removed. Warning is thrown. low speed due to jam is omitted.
+                if(ped->GetTimeInJam() > ped->GetPatienceTime() &&
+                   ped->GetGlobalTime() > 10000 + ped->GetPremovementTime() &&
+                   std::max(ped->GetMeanVelOverRecTime(), ped->GetV().Norm()) < 0.01 &&
+                   size == 0) // size length of peds neighbour vector
+                {
+                    LOG_WARNING(
+                        "ped {:d} with vmean {:f} has been deleted in room {:d}/{:d} after time "
+                        "{:f}s (current={:f}",
+                        ped->GetID(),
+                        ped->GetMeanVelOverRecTime(),
+                        ped->GetRoomID(),
+                        ped->GetSubRoomID(),
+                        ped->GetGlobalTime(),
+                        current);
+                    //TODO KKZ track deleted peds
+                    toRemove[p] = true;
                 }
-            }
-            //TODO get spacing to walls
-            //TODO update direction every DT?
-
-            // calculate min spacing
-            std::sort(spacings.begin(), spacings.end(), sort_pred());
-            double spacing = spacings[0].first;
-            //============================================================
-            // TODO: Hack for Head on situations: ped1 x ------> | <------- x ped2
-            if(0 && direction.NormSquare() < 0.5) {
-                double pi_half = 1.57079663;
-                double alpha   = pi_half * exp(-spacing);
-                direction      = e0(ped, room).Rotate(cos(alpha), sin(alpha));
-                printf(
-                    "\nRotate %f, %f, norm = %f alpha = %f, spacing = %f\n",
-                    direction._x,
-                    direction._y,
-                    direction.NormSquare(),
-                    alpha,
-                    spacing);
-                getc(stdin);
-            }
-            //============================================================
-            Point speed = direction.Normalized() * OptimalSpeed(ped, spacing);
-            result_acc.push_back(speed);
-
-
-            spacings.clear(); //clear for ped p
-
-            // stuck peds get removed. Warning is thrown. low speed due to jam is omitted.
-            if(ped->GetTimeInJam() > ped->GetPatienceTime() &&
-               ped->GetGlobalTime() > 10000 + ped->GetPremovementTime() &&
-               std::max(ped->GetMeanVelOverRecTime(), ped->GetV().Norm()) < 0.01 &&
-               size == 0) // size length of peds neighbour vector
-            {
-                LOG_WARNING(
-                    "ped {:d} with vmean {:f} has been deleted in room {:d}/{:d} after time "
-                    "{:f}s (current={:f}",
-                    ped->GetID(),
-                    ped->GetMeanVelOverRecTime(),
-                    ped->GetRoomID(),
-                    ped->GetSubRoomID(),
-                    ped->GetGlobalTime(),
-                    current);
-                //TODO KKZ track deleted peds
-#pragma omp critical(VelocityModel_ComputeNextTimeStep_pedsToRemove)
-                pedsToRemove.push_back(ped);
-            }
 
-        } // for p
+            } // for n
+        }     // for w
 
-#pragma omp barrier
-        // update
-        for(int p = start; p <= end; ++p) {
+        // update, the implicit barrier of the loop above separates both phases
+#pragma omp for schedule(static)
+        for(std::size_t p = 0; p < nSize; ++p) {
             Pedestrian * ped = allPeds[p];
 
-            Point v_neu   = result_acc[p - start];
-            Point pos_neu = ped->GetPos() + v_neu * deltaT;
+            Point v_neu   = result_acc[p];
+            Point pos_neu = kinematics.GetPos(p) + v_neu * deltaT;
 
             //Jam is based on the current velocity
             if(v_neu.Norm() >= ped->GetV0Norm() * 0.5) {
@@ -284,16 +304,21 @@ void VelocityModel::ComputeNextTimeStep(
                 }
             }
             ped->SetV(v_neu);
+            kinematics.Store(p, *ped);
         }
     } //end parallel
 
-    // remove the pedestrians that have left the building
-    for(unsigned int p = 0; p < pedsToRemove.size(); p++) {
-        building->DeletePedestrian(pedsToRemove[p]);
+    std::vector<Pedestrian *> pedsToRemove;
+    for(std::size_t p = 0; p < nSize; ++p) {
+        if(toRemove[p]) {
+            pedsToRemove.push_back(allPeds[p]);
+        }
     }
-    pedsToRemove.clear();
+    // remove the pedestrians that have left the building
+    building->DeletePedestrians(pedsToRemove);
 }
 
+template <bool floorfieldDirection>
 Point VelocityModel::e0(Pedestrian * ped, Room * room) const
 {
     Point target;
@@ -323,8 +348,7 @@ Point VelocityModel::e0(Pedestrian * ped, Room * room) const
     Point lastE0 = ped->GetLastE0();
     ped->SetLastE0(target - pos);
 
-    if((dynamic_cast<DirectionLocalFloorfield *>(_direction->GetDirectionStrategy().get())) ||
-       (dynamic_cast<DirectionSubLocalFloorfield *>(_direction->GetDirectionStrategy().get()))) {
+    if(floorfieldDirection) {
         desired_direction = target - pos;
         if(desired_direction.NormSquare() < 0.25 && !ped->IsWaiting()) {
             desired_direction = lastE0;
@@ -353,101 +377,44 @@ double VelocityModel::OptimalSpeed(Pedestrian * ped, double spacing) const
     return speed;
 }
 
-// return spacing and id of the nearest pedestrian
-my_pair
-VelocityModel::GetSpacing(Pedestrian * ped1, Pedestrian * ped2, Point ei, int periodic) const
-{
-    Point distp12 = ped2->GetPos() - ped1->GetPos(); // inversed sign
-    if(periodic) {
-        double x   = ped1->GetPos()._x;
-        double x_j = ped2->GetPos()._x;
-
-        if((xRight - x) + (x_j - xLeft) <= cutoff) {
-            distp12._x = distp12._x + xRight - xLeft;
-        }
-    }
-    double Distance = distp12.Norm();
-    double l        = 2 * ped1->GetEllipse().GetBmax();
-    Point ep12;
-    if(Distance >= J_EPS) {
-        ep12 = distp12.Normalized();
-    } else {
-        LOG_WARNING(
-            "VelocityModel::GetSPacing() ep12 can not be calculated! Pedestrians are to close to "
-            "each other ({:f})",
-            Distance);
-        my_pair(FLT_MAX, ped2->GetID());
-        exit(EXIT_FAILURE); //TODO
-    }
-
-    double condition1 = ei.ScalarProduct(ep12); // < e_i , e_ij > should be positive
-    double condition2 =
-        ei.Rotate(0, 1).ScalarProduct(ep12); // theta = pi/2. condition2 should <= than l/Distance
-    condition2 = (condition2 > 0) ? condition2 : -condition2; // abs
-
-    if((condition1 >= 0) && (condition2 <= l / Distance))
-        // return a pair <dist, condition1>. Then take the smallest dist. In case of equality the biggest condition1
-        return my_pair(distp12.Norm(), ped2->GetID());
-    else
-        return my_pair(FLT_MAX, ped2->GetID());
-}
-Point VelocityModel::ForceRepPed(Pedestrian * ped1, Pedestrian * ped2, int periodic) const
+template <bool periodic>
+Point VelocityModel::GetOffset(
+    const AgentsKinematics & kinematics,
+    std::size_t ped1,
+    std::size_t ped2) const
 {
-    Point F_rep(0.0, 0.0);
     // x- and y-coordinate of the distance between p1 and p2
-    Point distp12 = ped2->GetPos() - ped1->GetPos();
+    Point distp12 = kinematics.GetPos(ped2) - kinematics.GetPos(ped1);
 
     if(periodic) {
-        double x   = ped1->GetPos()._x;
-        double x_j = ped2->GetPos()._x;
+        double x   = kinematics._x[ped1];
+        double x_j = kinematics._x[ped2];
         if((xRight - x) + (x_j - xLeft) <= cutoff) {
             distp12._x = distp12._x + xRight - xLeft;
         }
     }
+    return distp12;
+}
 
-    double Distance = distp12.Norm();
-    Point ep12; // x- and y-coordinate of the normalized vector between p1 and p2
-    double R_ij;
-    double l = 2 * ped1->GetEllipse().GetBmax();
-
-    if(Distance >= J_EPS) {
-        ep12 = distp12.Normalized();
-    } else {
-        LOG_ERROR(
-            "VelocityModel::forcePedPed() ep12 can not be calculated! Pedestrians are too near to "
-            "each other (dist={:f}). Adjust <a> value in force_ped to counter this. Affected "
-            "pedestrians ped1 {:d} at ({:f},{:f}) and ped2 {:d} at ({:f}, {:f})",
-            Distance,
-            ped1->GetID(),
-            ped1->GetPos()._x,
-            ped1->GetPos()._y,
-            ped2->GetID(),
-            ped2->GetPos()._x,
-            ped2->GetPos()._y);
-        exit(EXIT_FAILURE); //TODO: quick and dirty fix for issue #158
-                            // (sometimes sources create peds on the same location)
-    }
-    Point ei = ped1->GetV().Normalized();
-    if(ped1->GetV().NormSquare() < 0.01) {
-        ei = ped1->GetV0().Normalized();
-    }
-    double condition1 = ei.ScalarProduct(ep12);            // < e_i , e_ij > should be positive
-    condition1        = (condition1 > 0) ? condition1 : 0; // abs
-
-    R_ij  = -_aPed * exp((l - Distance) / _DPed);
-    F_rep = ep12 * R_ij;
-
-    return F_rep;
-} //END Velocity:ForceRepPed()
-
+template <bool wallField>
 Point VelocityModel::ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const
 {
     Point f(0., 0.);
     const Point & centroid = subroom->GetCentroid();
     bool inside            = subroom->IsInSubRoom(centroid);
-    //first the walls
-    for(const auto & wall : subroom->GetAllWalls()) {
-        f += ForceRepWall(ped, wall, centroid, inside);
+
+    // a subroom without a field, e.g. one created after Init(), falls back to all walls
+    const bool useField = wallField && subroom->GetWallDistanceField().IsBuilt();
+    if(useField) {
+        // the field holds the walls and the obstacle walls, only the close ones are evaluated
+        subroom->GetWallDistanceField().ForEachWallInCutoff(ped->GetPos(), [&](const Line & wall) {
+            f += ForceRepWall(ped, wall, centroid, inside);
+        });
+    } else {
+        //first the walls
+        for(const auto & wall : subroom->GetAllWalls()) {
+            f += ForceRepWall(ped, wall, centroid, inside);
+        }
     }
 
     //then the obstacles
@@ -459,7 +426,7 @@ Point VelocityModel::ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const
                 subroom->GetRoomID(),
                 subroom->GetSubRoomID());
             exit(EXIT_FAILURE);
-        } else
+        } else if(!useField)
             for(const auto & wall : obst->GetAllWalls()) {
                 f += ForceRepWall(ped, wall, centroid, inside);
             }
@@ -520,7 +487,8 @@ Point VelocityModel::ForceRepWall(
     if(distGoal < J_EPS_GOAL * J_EPS_GOAL)
         return F_wrep;
     //-------------------------
-    R_iw   = -_aWall * exp((l - Distance) / _DWall);
+    const double strength = (l - Distance) / _DWall;
+    R_iw                  = -_aWall * (_fastMath ? FastExp(strength) : exp(strength));
     F_wrep = e_iw * R_iw;
 
     return F_wrep;
@@ -535,6 +503,8 @@ std::string VelocityModel::GetDescription()
     rueck.append(tmp);
     sprintf(tmp, "\t\tD: \t\tPed: %f \tWall: %f\n", _DPed, _DWall);
     rueck.append(tmp);
+    sprintf(tmp, "\t\tFast math: \t%s\n", _fastMath ? "true" : "false");
+    rueck.append(tmp);
     return rueck;
 }
 
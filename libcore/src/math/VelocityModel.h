@@ -32,21 +32,11 @@
 #include "OperationalModel.h"
 #include "geometry/Building.h"
 
+#include <cstddef>
 #include <vector>
 
-typedef std::pair<double, double> my_pair;
-// sort with respect to first element (ascending).
-// In case of equality sort with respect to second element (descending)
-struct sort_pred {
-    bool operator()(const my_pair & left, const my_pair & right)
-    {
-        return (left.first == right.first) ? (left.second > right.second) :
-                                             (left.first < right.first);
-    }
-};
-
-
 //forward declaration
+class AgentsKinematics;
 class Pedestrian;
 class DirectionStrategy;
 
@@ -68,6 +58,23 @@ private:
 
     double _aWall;
     double _DWall;
+    /// walls farther away do not act on an agent, 0 for all walls
+    double _wallCutoff;
+    /// approximate the exponential repulsion by FastExp()
+    bool _fastMath;
+    using ComputeStepFunction = void (VelocityModel::*)(double, double, Building *);
+    /// ComputeStep() for the policies of the simulation, selected in Init()
+    ComputeStepFunction _computeStep;
+
+    /**
+      * ComputeNextTimeStep() for fixed policies. They are known when the simulation starts, so
+      * the loop over the pedestrians does not branch on them.
+      * @tparam periodic the geometry is periodic in x
+      * @tparam wallField the subrooms have wall distance fields, i.e. a wall cutoff is set
+      * @tparam floorfieldDirection the direction strategy is based on a local floor field
+      */
+    template <bool periodic, bool wallField, bool floorfieldDirection>
+    void ComputeStep(double current, double deltaT, Building * building);
 
     /**
       * Optimal velocity function \f$ V(spacing) =\min{v_0, \max{0, (s-l)/T}}  \f$
@@ -86,39 +93,38 @@ private:
       * @param ped: Pointer to Pedestrians
       * @param room: Pointer to room
       *
+      * @tparam floorfieldDirection the direction strategy is based on a local floor field
+      *
       * @return Point
       */
+    template <bool floorfieldDirection>
     Point e0(Pedestrian * ped, Room * room) const;
     /**
-      * Get the spacing between ped1 and ped2
+      * Position of ped2 relative to ped1. In a periodic corridor a neighbour close to the right
+      * end is seen behind the left end.
       *
-      * @param ped1 Pointer to Pedestrian: First pedestrian
-      * @param ped2 Pointer to Pedestrian: Second pedestrian
-      * @param ei the direction of pedestrian.
-      * This direction is: \f$ e_0 + \sum_j{R(spacing_{ij})*e_{ij}}\f$
-      * and should be calculated *before* calling OptimalSpeed
-      * @return Point
-      */
-    my_pair GetSpacing(Pedestrian * ped1, Pedestrian * ped2, Point ei, int periodic) const;
-    /**
-      * Repulsive force between two pedestrians ped1 and ped2 according to
-      * the Velocity model (to be published in TGF15)
+      * @param kinematics kinematic state of all pedestrians
+      * @param ped1 slot of the first pedestrian in \p kinematics
+      * @param ped2 slot of the second pedestrian in \p kinematics
       *
-      * @param ped1 Pointer to Pedestrian: First pedestrian
-      * @param ped2 Pointer to Pedestrian: Second pedestrian
+      * @tparam periodic the geometry is periodic in x
       *
       * @return Point
       */
-    Point ForceRepPed(Pedestrian * ped1, Pedestrian * ped2, int periodic) const;
+    template <bool periodic>
+    Point GetOffset(const AgentsKinematics & kinematics, std::size_t ped1, std::size_t ped2) const;
     /**
       * Repulsive force acting on pedestrian <ped> from the walls in
-      * <subroom>. The sum of all repulsive forces of the walls in <subroom> is calculated
+      * <subroom>. The sum of all repulsive forces of the walls in <subroom> is calculated. With a
+      * wall cutoff only the walls within the cutoff are evaluated, see WallDistanceField.
       * @see ForceRepWall
       * @param ped Pointer to Pedestrian
       * @param subroom Pointer to SubRoom
+      * @tparam wallField the subrooms have wall distance fields
       *
       * @return Point
       */
+    template <bool wallField>
     Point ForceRepRoom(Pedestrian * ped, SubRoom * subroom) const;
     /**
       * Repulsive force between pedestrian <ped> and wall <l>
@@ -136,7 +142,9 @@ public:
         double aped,
         double Dped,
         double awall,
-        double Dwall);
+        double Dwall,
+        double wallCutoff,
+        bool fastMath = false);
     virtual ~VelocityModel(void);
 
     /**
@@ -174,7 +182,7 @@ public:
     virtual std::string GetDescription();
 
     /**
-      * initialize the phi angle
+      * initialize the phi angle and select the ComputeStep() for the policies of the simulation
       * @param building
       */
     virtual bool Init(Building * building);
@@ -185,7 +193,8 @@ public:
       * @param current the actual time
       * @param deltaT the next timestep
       * @param building the geometry object
-      * @param periodic: used in some utests for periodic scenarios (very specific)
+      * @param periodic: used in some utests for periodic scenarios (very specific), the same as
+      * Configuration::IsPeriodic() that selected the step in Init()
       */
     virtual void
     ComputeNextTimeStep(double current, double deltaT, Building * building, int periodic);
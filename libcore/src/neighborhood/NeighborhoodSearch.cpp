@@ -24,14 +24,10 @@
  **/
 #include "NeighborhoodSearch.h"
 
+#include "general/OpenMP.h"
 #include "pedestrian/Pedestrian.h"
 
-#include <algorithm>
-#include <iterator>
-#include <shared_mutex>
-
-
-std::shared_mutex grid_mutex;
+#include <numeric>
 
 NeighborhoodSearch::NeighborhoodSearch(
     double gridXmin,
@@ -44,7 +40,7 @@ NeighborhoodSearch::NeighborhoodSearch(
     _cellSize(cellSize),
     _gridSizeX((int) ((gridXmax - _gridXmin) / _cellSize) + 1 + 2), // 1 dummy cell on each side
     _gridSizeY((int) ((gridYmax - _gridYmin) / _cellSize) + 1 + 2), // 1 dummy cell on each side
-    _grid(_gridSizeY, _gridSizeX)
+    _cellStart((std::size_t) _gridSizeX * _gridSizeY + 1, 0)
 {
 }
 
@@ -52,16 +48,213 @@ NeighborhoodSearch::~NeighborhoodSearch() {}
 
 void NeighborhoodSearch::Update(const std::vector<Pedestrian *> & peds)
 {
-    std::unique_lock exclusive_lock(grid_mutex);
-    _grid.clear();
+    const std::size_t nSize = peds.size();
+    _unsortedEntries.resize(nSize);
+    _entryCells.resize(nSize);
+
+    int nThreads = omp_get_max_threads();
+    int partSize = ((int) nSize > nThreads) ? (int) (nSize / nThreads) : (int) nSize;
+    if(partSize == (int) nSize)
+        nThreads = 1; // not worthy to parallelize
+
+    // the first pass touches the pedestrians and determines the cell of each one
+#pragma omp parallel default(shared) num_threads(nThreads)
+    {
+        const int threadID = omp_get_thread_num();
+        const int start    = threadID * partSize;
+        const int end      = (threadID < nThreads - 1) ? (threadID + 1) * partSize : (int) nSize;
+        for(int p = start; p < end; ++p) {
+            const Pedestrian * ped = peds[p];
+            const Point & pos      = ped->GetPos();
+            const double z         = _elevationBand > 0 ? ped->GetElevation() : 0.;
+            const int band         = _elevationBand > 0 ? GetBand(z) : 0;
+            _unsortedEntries[p]    = CellEntry{peds[p], pos, z, ped->GetID(), (std::size_t) p};
+            _entryCells[p]         = GetCellIndex(GetCellX(pos._x), GetCellY(pos._y), band);
+        }
+    }
+
+    // counting sort of the entries by cell
+    std::fill(std::begin(_cellStart), std::end(_cellStart), 0);
+    for(std::size_t cell : _entryCells) {
+        ++_cellStart[cell + 1];
+    }
+    std::partial_sum(std::begin(_cellStart), std::end(_cellStart), std::begin(_cellStart));
+
+    _entries.resize(nSize);
+    for(std::size_t p = 0; p < nSize; ++p) {
+        // _cellStart[cell] is used as insertion cursor and ends up at the start of the next cell
+        _entries[_cellStart[_entryCells[p]]++] = _unsortedEntries[p];
+    }
+    // shift the cursors back to the start of each cell
+    std::copy_backward(std::begin(_cellStart), std::end(_cellStart) - 1, std::end(_cellStart));
+    _cellStart.front() = 0;
+
+    if(_verletSkin > 0 && VerletListsOutdated(peds)) {
+        BuildVerletLists(peds);
+    }
+}
+
+std::vector<Pedestrian *> NeighborhoodSearch::GetNearestNeighbours(
+    const Point & pos,
+    int id,
+    std::size_t k,
+    double maxRadius) const
+{
+    // squared distance and entry of all pedestrians found so far
+    std::vector<std::pair<double, const CellEntry *>> candidates;
+    auto byDistance = [](const std::pair<double, const CellEntry *> & a,
+                         const std::pair<double, const CellEntry *> & b) {
+        return a.first < b.first || (a.first == b.first && a.second->id < b.second->id);
+    };
+
+    const double maxRadiusSquare = maxRadius * maxRadius;
+    auto collect = [&pos, id, maxRadiusSquare, &candidates](const CellEntry & entry) {
+        const double distSquare = (entry.pos - pos).NormSquare();
+        if(entry.id != id && distSquare <= maxRadiusSquare) {
+            candidates.emplace_back(distSquare, &entry);
+        }
+    };
+
+    const int l       = std::clamp(GetCellX(pos._x), 0, _gridSizeX - 1);
+    const int m       = std::clamp(GetCellY(pos._y), 0, _gridSizeY - 1);
+    const int maxRing = std::max(_gridSizeX, _gridSizeY);
+    for(int ring = 0; k > 0 && ring <= maxRing; ++ring) {
+        // visit only the border of the square of cells around (l, m), clipped to the grid
+        const int xMin      = std::max(l - ring, 0);
+        const int xMax      = std::min(l + ring, _gridSizeX - 1);
+        const bool hasBelow = m - ring >= 0;
+        const bool hasAbove = ring > 0 && m + ring < _gridSizeY;
+        const int yMin      = hasBelow ? m - ring + 1 : 0;
+        const int yMax      = hasAbove ? m + ring - 1 : _gridSizeY - 1;
+        if(hasBelow) {
+            VisitCells(xMin, xMax, m - ring, m - ring, std::nullopt, collect);
+        }
+        if(hasAbove) {
+            VisitCells(xMin, xMax, m + ring, m + ring, std::nullopt, collect);
+        }
+        if(ring > 0 && l - ring >= 0) {
+            VisitCells(l - ring, l - ring, yMin, yMax, std::nullopt, collect);
+        }
+        if(ring > 0 && l + ring < _gridSizeX) {
+            VisitCells(l + ring, l + ring, yMin, yMax, std::nullopt, collect);
+        }
+
+        // all pedestrians closer than this distance were visited
+        const double covered = ring * _cellSize;
+        if(covered >= maxRadius) {
+            break;
+        }
+        if(candidates.size() >= k) {
+            std::nth_element(
+                std::begin(candidates),
+                std::begin(candidates) + (k - 1),
+                std::end(candidates),
+                byDistance);
+            if(candidates[k - 1].first <= covered * covered) {
+                break;
+            }
+        }
+    }
+
+    std::sort(std::begin(candidates), std::end(candidates), byDistance);
+    candidates.resize(std::min(candidates.size(), k));
+
+    std::vector<Pedestrian *> neighbours;
+    neighbours.reserve(candidates.size());
+    for(const auto & candidate : candidates) {
+        neighbours.push_back(candidate.second->ped);
+    }
+    return neighbours;
+}
+
+void NeighborhoodSearch::SetElevationBands(
+    double minElevation,
+    double maxElevation,
+    double bandHeight)
+{
+    _elevationBand = bandHeight > 0 ? bandHeight : 0;
+    _elevationMin  = minElevation;
+    _numBands      = 1;
+    if(_elevationBand > 0 && maxElevation > minElevation) {
+        _numBands = (int) ((maxElevation - minElevation) / _elevationBand) + 1;
+    }
+    _cellStart.assign((std::size_t) _gridSizeX * _gridSizeY * _numBands + 1, 0);
+    _entries.clear();
+    // force a rebuild of the Verlet lists with the next update
+    _verletPeds.clear();
+}
+
+void NeighborhoodSearch::SetVerletSkin(double skin)
+{
+    _verletSkin = skin;
+    // force a rebuild with the next update
+    _verletPeds.clear();
+    _verletNeighbours.clear();
+    _verletStart.assign(1, 0);
+}
 
-    for(auto & ped : peds) {
-        // determine the cell coordinates of pedestrian i
-        int ix =
-            (int) ((ped->GetPos()._x - _gridXmin) / _cellSize) + 1; // +1 because of dummy cells
-        int iy = (int) ((ped->GetPos()._y - _gridYmin) / _cellSize) + 1;
+bool NeighborhoodSearch::VerletListsOutdated(const std::vector<Pedestrian *> & peds) const
+{
+    if(peds != _verletPeds) {
+        return true;
+    }
+    const double maxDisplacement = 0.5 * _verletSkin;
+    for(std::size_t p = 0; p < peds.size(); ++p) {
+        if((_unsortedEntries[p].pos - _verletPositions[p]).NormSquare() >
+           maxDisplacement * maxDisplacement) {
+            return true;
+        }
+    }
+    return false;
+}
 
-        _grid[iy][ix].push_back(ped);
+void NeighborhoodSearch::BuildVerletLists(const std::vector<Pedestrian *> & peds)
+{
+    const std::size_t nSize = peds.size();
+    const double radius     = _cellSize + _verletSkin;
+    _verletPeds             = peds;
+    _verletPositions.resize(nSize);
+    _verletStart.assign(nSize + 1, 0);
+    ++_verletListBuilds;
+
+    int nThreads = omp_get_max_threads();
+    int partSize = ((int) nSize > nThreads) ? (int) (nSize / nThreads) : (int) nSize;
+    if(partSize == (int) nSize)
+        nThreads = 1; // not worthy to parallelize
+    _threadNeighbours.resize(nThreads);
+
+    // every thread collects the lists of a contiguous range of pedestrians
+#pragma omp parallel default(shared) num_threads(nThreads)
+    {
+        const int threadID = omp_get_thread_num();
+        const int start    = threadID * partSize;
+        const int end      = (threadID < nThreads - 1) ? (threadID + 1) * partSize : (int) nSize;
+        std::vector<std::size_t> & neighbours = _threadNeighbours[threadID];
+        neighbours.clear();
+        for(int p = start; p < end; ++p) {
+            const std::size_t index = p;
+            const std::size_t count = neighbours.size();
+            _verletPositions[p]     = _unsortedEntries[p].pos;
+            const std::optional<double> z = EntryElevation(_unsortedEntries[p]);
+            auto collect                  = [index, &neighbours](const CellEntry & entry) {
+                if(entry.index != index) {
+                    neighbours.push_back(entry.index);
+                }
+            };
+            VisitRadius(_verletPositions[p], radius, z, collect);
+            _verletStart[p + 1] = neighbours.size() - count;
+        }
+    }
+
+    // the ranges of the threads are consecutive, so the lists are concatenated in thread order
+    std::partial_sum(std::begin(_verletStart), std::end(_verletStart), std::begin(_verletStart));
+    _verletNeighbours.clear();
+    _verletNeighbours.reserve(_verletStart.back());
+    for(int threadID = 0; threadID < nThreads; ++threadID) {
+        _verletNeighbours.insert(
+            std::end(_verletNeighbours),
+            std::begin(_threadNeighbours[threadID]),
+            std::end(_threadNeighbours[threadID]));
     }
 }
 
@@ -69,30 +262,60 @@ void NeighborhoodSearch::Update(const std::vector<Pedestrian *> & peds)
 std::vector<Pedestrian *> NeighborhoodSearch::GetNeighbourhood(const Pedestrian * ped) const
 {
     std::vector<Pedestrian *> neighbourhood;
+    ForEachNeighbour(ped, [&neighbourhood](Pedestrian * other) { neighbourhood.push_back(other); });
+    return neighbourhood;
+}
 
-    double xPed = ped->GetPos()._x;
-    double yPed = ped->GetPos()._y;
-
-    int l = (int) ((xPed - _gridXmin) / _cellSize) + 1; // +1 because of dummy cells
-    int k = (int) ((yPed - _gridYmin) / _cellSize) + 1;
-
-    /**
-     * We only aquire a shared lock here for reading data in the grid.
-     * It is not allowed to write data using a shared lock.
-     * Otherwise thread safety is lost.
-     */
-    std::shared_lock shared_lock(grid_mutex);
-
-    // all neighbor cells
-    for(int i = l - 1; i <= l + 1; ++i) {
-        for(int j = k - 1; j <= k + 1; ++j) {
-            std::copy_if(
-                _grid[j][i].begin(),
-                _grid[j][i].end(),
-                std::back_inserter(neighbourhood),
-                [ped](auto & other_ped) { return other_ped->GetID() != ped->GetID(); });
+std::uint64_t NeighborhoodSearch::GetMortonKey(const Point & pos) const
+{
+    // spreads the lower 32 bits of v to the even bits of the result
+    auto spread = [](std::uint64_t v) {
+        v &= 0xFFFFFFFFull;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    };
+    const int x = std::clamp(GetCellX(pos._x), 0, std::max(_gridSizeX - 1, 0));
+    const int y = std::clamp(GetCellY(pos._y), 0, std::max(_gridSizeY - 1, 0));
+    return spread(x) | (spread(y) << 1);
+}
+
+void NeighborhoodSearch::GetCellBlocks(
+    std::size_t blockSize,
+    std::vector<std::size_t> & order,
+    std::vector<std::size_t> & blockStart) const
+{
+    order.resize(_entries.size());
+    for(std::size_t e = 0; e < _entries.size(); ++e) {
+        order[e] = _entries[e].index;
+    }
+
+    // blocks end at cell borders only, so a crowded cell is never split
+    blockStart.assign(1, 0);
+    for(std::size_t cell = 1; cell < _cellStart.size(); ++cell) {
+        if(_cellStart[cell] - blockStart.back() >= std::max<std::size_t>(blockSize, 1)) {
+            blockStart.push_back(_cellStart[cell]);
         }
     }
+    if(blockStart.back() != order.size()) {
+        blockStart.push_back(order.size());
+    }
+}
 
-    return neighbourhood;
+Point NeighborhoodSearch::PositionOf(const Pedestrian * ped)
+{
+    return ped->GetPos();
+}
+
+int NeighborhoodSearch::IDOf(const Pedestrian * ped)
+{
+    return ped->GetID();
+}
+
+double NeighborhoodSearch::ElevationOf(const Pedestrian * ped)
+{
+    return ped->GetElevation();
 }
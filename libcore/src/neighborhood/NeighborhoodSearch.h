@@ -23,24 +23,71 @@
  **/
 #pragma once
 
-#include "Grid2D.h"
 #include "geometry/Point.h"
 
-#include <deque>
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 //forwarded classes
 class Pedestrian;
 class Building;
 
+/**
+ * Linked cells for the neighbourhood queries of the operational models.
+ *
+ * The cells are stored as one array of entries sorted by cell plus the offset of each cell into
+ * that array. Update() rebuilds both with a counting sort in two linear passes. The cells are
+ * read only afterwards. Queries do not lock, it is up to the caller to not call Update() while
+ * other threads are running queries.
+ */
 class NeighborhoodSearch
 {
 private:
-    double _gridXmin, _gridYmin, _cellSize;
-    int _gridSizeX, _gridSizeY;
+    /// entry of a cell, the position is copied to filter by distance without touching the ped
+    struct CellEntry {
+        Pedestrian * ped;
+        Point pos;
+        /// elevation, only set if elevation bands are used
+        double z;
+        int id;
+        /// position of ped in the vector passed to Update()
+        std::size_t index;
+    };
+
+    double _gridXmin = 0, _gridYmin = 0, _cellSize = 1;
+    int _gridSizeX = 0, _gridSizeY = 0;
+
+    /// height of the elevation bands, the grid is 2D if it is not positive
+    double _elevationBand = 0;
+    double _elevationMin  = 0;
+    int _numBands         = 1;
+
+    /// entries of all cells sorted by cell, cell c holds [_cellStart[c], _cellStart[c + 1])
+    std::vector<CellEntry> _entries;
+    std::vector<std::size_t> _cellStart = std::vector<std::size_t>(1, 0);
 
-    Grid2D<std::deque<Pedestrian *>> _grid;
+    /// scratch buffers of Update(), kept to avoid reallocations
+    std::vector<CellEntry> _unsortedEntries;
+    std::vector<std::size_t> _entryCells;
+
+    /// skin distance of the Verlet lists, the lists are disabled if it is not positive
+    double _verletSkin = 0;
+    /// neighbours of pedestrian i are [_verletStart[i], _verletStart[i + 1]) in _verletNeighbours
+    std::vector<std::size_t> _verletNeighbours;
+    std::vector<std::size_t> _verletStart;
+    /// pedestrians and their positions when the Verlet lists were built
+    std::vector<Pedestrian *> _verletPeds;
+    std::vector<Point> _verletPositions;
+    /// per thread buffers used while building the Verlet lists
+    std::vector<std::vector<std::size_t>> _threadNeighbours;
+    std::size_t _verletListBuilds = 0;
 
 public:
     NeighborhoodSearch()                           = default;
@@ -68,14 +115,268 @@ public:
     ~NeighborhoodSearch();
 
     /**
-      *Update the cells occupation
+      * Update the cells occupation. Pedestrians within a cell keep the order of peds.
+      * If Verlet lists are enabled they are rebuilt when they became invalid.
       */
     void Update(const std::vector<Pedestrian *> & peds);
 
+    /**
+     * Splits the grid into elevation bands of height bandHeight between minElevation and
+     * maxElevation. Pedestrians whose elevations differ by more than bandHeight are never
+     * neighbours, so agents on stacked floors do not see each other. Queries by position only
+     * can not use the elevation and return pedestrians of all bands.
+     * @param minElevation lowest elevation in the building
+     * @param maxElevation highest elevation in the building
+     * @param bandHeight height of a band in m, values <= 0 disable the elevation bands
+     */
+    void SetElevationBands(double minElevation, double maxElevation, double bandHeight);
+
+    double GetElevationBand() const { return _elevationBand; }
+
+    /**
+     * Enables Verlet lists for ForEachNeighbourIndex(). The list of a pedestrian holds all
+     * pedestrians within cell size + skin. Update() reuses the lists until a pedestrian moved more
+     * than half the skin or pedestrians were added, removed or reordered.
+     * @param skin skin distance in m, values <= 0 disable the Verlet lists
+     */
+    void SetVerletSkin(double skin);
+
+    double GetVerletSkin() const { return _verletSkin; }
+
+    /**
+     * @return number of times the Verlet lists were built
+     */
+    std::size_t GetVerletListBuilds() const { return _verletListBuilds; }
+
+    /**
+     * Returns the position of the cell containing pos on the Morton (Z-order) curve through the
+     * grid. Sorting pedestrians by this key keeps pedestrians of nearby cells close together.
+     * @param pos position
+     * @return Morton key of the cell
+     */
+    std::uint64_t GetMortonKey(const Point & pos) const;
+
+    /**
+     * Groups the pedestrians of the last Update() into blocks of whole cells. Cells are added in
+     * grid order until a block holds at least blockSize pedestrians, so a block covers a compact
+     * area and its pedestrians share most of their neighbours. The blocks of crowded and of empty
+     * areas differ a lot in cost and are meant to be scheduled dynamically.
+     * @param blockSize minimal number of pedestrians in a block, only the last block may be smaller
+     * @param order receives the positions in the vector passed to Update() sorted by cell
+     * @param blockStart receives the block starts, block b is [blockStart[b], blockStart[b + 1])
+     * in order
+     */
+    void GetCellBlocks(
+        std::size_t blockSize,
+        std::vector<std::size_t> & order,
+        std::vector<std::size_t> & blockStart) const;
+
     /**
       * Returns neighbourhood of the pedestrians ped
       * @param ped
       * @return neighbourhood
       */
     std::vector<Pedestrian *> GetNeighbourhood(const Pedestrian * ped) const;
+
+    /**
+     * Calls fn(Pedestrian *) for every pedestrian in the cell of ped and the eight cells around
+     * it, except for ped itself. These are the same pedestrians GetNeighbourhood() returns, but
+     * no memory is allocated.
+     * @param ped pedestrian whose neighbours are visited
+     * @param fn callable invoked with each neighbour
+     */
+    template <typename F>
+    void ForEachNeighbour(const Pedestrian * ped, F && fn) const
+    {
+        const int id                  = IDOf(ped);
+        const Point pos               = PositionOf(ped);
+        const std::optional<double> z = QueryElevation(ped);
+        VisitNeighbourCells(pos, z, [id, &fn](const CellEntry & entry) {
+            if(entry.id != id) {
+                fn(entry.ped);
+            }
+        });
+    }
+
+    /**
+     * Calls fn(Pedestrian *) for every pedestrian in the cells around pos except for the
+     * pedestrian with ID id.
+     * @param pos position of the query
+     * @param id ID of the pedestrian to skip
+     * @param fn callable invoked with each neighbour
+     */
+    template <typename F>
+    void ForEachNeighbour(const Point & pos, int id, F && fn) const
+    {
+        VisitNeighbourCells(pos, std::nullopt, [id, &fn](const CellEntry & entry) {
+            if(entry.id != id) {
+                fn(entry.ped);
+            }
+        });
+    }
+
+    /**
+     * Calls fn(Pedestrian *) for every pedestrian with a distance of at most radius to ped,
+     * except for ped itself. The radius may exceed the cell size. Distances are computed from the
+     * positions at the last Update().
+     * @param ped pedestrian whose neighbours are visited
+     * @param radius search radius in m
+     * @param fn callable invoked with each neighbour
+     */
+    template <typename F>
+    void ForEachNeighbour(const Pedestrian * ped, double radius, F && fn) const
+    {
+        const int id                  = IDOf(ped);
+        const Point pos               = PositionOf(ped);
+        const std::optional<double> z = QueryElevation(ped);
+        VisitRadius(pos, radius, z, [id, &fn](const CellEntry & entry) {
+            if(entry.id != id) {
+                fn(entry.ped);
+            }
+        });
+    }
+
+    /**
+     * Calls fn(Pedestrian *) for every pedestrian with a distance of at most radius to pos,
+     * except for the pedestrian with ID id.
+     * @param pos position of the query
+     * @param id ID of the pedestrian to skip
+     * @param radius search radius in m
+     * @param fn callable invoked with each neighbour
+     */
+    template <typename F>
+    void ForEachNeighbour(const Point & pos, int id, double radius, F && fn) const
+    {
+        VisitRadius(pos, radius, std::nullopt, [id, &fn](const CellEntry & entry) {
+            if(entry.id != id) {
+                fn(entry.ped);
+            }
+        });
+    }
+
+    /**
+     * Returns the k pedestrians closest to pos, except for the pedestrian with ID id. The cells
+     * are searched in rings around pos until no closer pedestrian can be found. Distances are
+     * computed from the positions at the last Update().
+     * @param pos position of the query
+     * @param id ID of the pedestrian to skip
+     * @param k maximal number of pedestrians
+     * @param maxRadius only pedestrians with a distance of at most maxRadius are returned
+     * @return pedestrians sorted by their distance to pos, ties are sorted by ID
+     */
+    std::vector<Pedestrian *> GetNearestNeighbours(
+        const Point & pos,
+        int id,
+        std::size_t k,
+        double maxRadius = std::numeric_limits<double>::max()) const;
+
+    /**
+     * Calls fn(std::size_t) with the index of every neighbour of peds[index], where peds is the
+     * vector passed to the last Update(). Without Verlet lists the neighbours are the pedestrians
+     * in the cell of peds[index] and the eight cells around it, as for ForEachNeighbour(). With
+     * Verlet lists they are the pedestrians within cell size + skin when the lists were built.
+     * @param index position of the pedestrian in the vector passed to Update()
+     * @param fn callable invoked with the index of each neighbour
+     */
+    template <typename F>
+    void ForEachNeighbourIndex(std::size_t index, F && fn) const
+    {
+        if(_verletSkin > 0) {
+            for(std::size_t n = _verletStart[index]; n < _verletStart[index + 1]; ++n) {
+                fn(_verletNeighbours[n]);
+            }
+            return;
+        }
+        const CellEntry & self = _unsortedEntries[index];
+        VisitNeighbourCells(self.pos, EntryElevation(self), [index, &fn](const CellEntry & entry) {
+            if(entry.index != index) {
+                fn(entry.index);
+            }
+        });
+    }
+
+private:
+    // +1 because of dummy cells
+    int GetCellX(double x) const { return (int) ((x - _gridXmin) / _cellSize) + 1; }
+    int GetCellY(double y) const { return (int) ((y - _gridYmin) / _cellSize) + 1; }
+    int GetBand(double z) const
+    {
+        return std::clamp((int) ((z - _elevationMin) / _elevationBand), 0, _numBands - 1);
+    }
+    std::size_t GetCellIndex(int x, int y, int band = 0) const
+    {
+        return ((std::size_t) band * _gridSizeY + y) * _gridSizeX + x;
+    }
+
+    std::optional<double> QueryElevation(const Pedestrian * ped) const
+    {
+        return _elevationBand > 0 ? std::optional<double>(ElevationOf(ped)) : std::nullopt;
+    }
+    std::optional<double> EntryElevation(const CellEntry & entry) const
+    {
+        return _elevationBand > 0 ? std::optional<double>(entry.z) : std::nullopt;
+    }
+
+    /**
+     * Visits all entries of the cells [xMin, xMax] x [yMin, yMax] column by column. If z is given
+     * only entries with an elevation difference of at most one band are visited.
+     */
+    template <typename F>
+    void VisitCells(int xMin, int xMax, int yMin, int yMax, std::optional<double> z, F && fn) const
+    {
+        int bandMin = 0;
+        int bandMax = _numBands - 1;
+        if(z && _numBands > 1) {
+            bandMin = std::max(GetBand(*z) - 1, 0);
+            bandMax = std::min(GetBand(*z) + 1, _numBands - 1);
+        }
+        for(int b = bandMin; b <= bandMax; ++b) {
+            for(int i = xMin; i <= xMax; ++i) {
+                for(int j = yMin; j <= yMax; ++j) {
+                    const std::size_t cell = GetCellIndex(i, j, b);
+                    for(std::size_t e = _cellStart[cell]; e < _cellStart[cell + 1]; ++e) {
+                        const CellEntry & entry = _entries[e];
+                        if(z && std::abs(entry.z - *z) > _elevationBand) {
+                            continue;
+                        }
+                        fn(entry);
+                    }
+                }
+            }
+        }
+    }
+
+    /// visits all entries in the cell of pos and the eight cells around it
+    template <typename F>
+    void VisitNeighbourCells(const Point & pos, std::optional<double> z, F && fn) const
+    {
+        const int l = GetCellX(pos._x);
+        const int k = GetCellY(pos._y);
+        VisitCells(l - 1, l + 1, k - 1, k + 1, z, std::forward<F>(fn));
+    }
+
+    /// visits all entries with a distance of at most radius to pos
+    template <typename F>
+    void VisitRadius(const Point & pos, double radius, std::optional<double> z, F && fn) const
+    {
+        const double radiusSquare = radius * radius;
+        VisitCells(
+            std::max(GetCellX(pos._x - radius), 0),
+            std::min(GetCellX(pos._x + radius), _gridSizeX - 1),
+            std::max(GetCellY(pos._y - radius), 0),
+            std::min(GetCellY(pos._y + radius), _gridSizeY - 1),
+            z,
+            [&pos, radiusSquare, &fn](const CellEntry & entry) {
+                if((entry.pos - pos).NormSquare() <= radiusSquare) {
+                    fn(entry);
+                }
+            });
+    }
+
+    bool VerletListsOutdated(const std::vector<Pedestrian *> & peds) const;
+    void BuildVerletLists(const std::vector<Pedestrian *> & peds);
+
+    static Point PositionOf(const Pedestrian * ped);
+    static int IDOf(const Pedestrian * ped);
+    static double ElevationOf(const Pedestrian * ped);
 };
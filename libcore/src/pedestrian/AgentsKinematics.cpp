@@ -0,0 +1,77 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "AgentsKinematics.h"
+
+#include "Pedestrian.h"
+
+void AgentsKinematics::Gather(const std::vector<Pedestrian *> & peds)
+{
+    Resize(peds.size());
+
+    for(std::size_t slot = 0; slot < peds.size(); ++slot) {
+        Pedestrian * ped = peds[slot];
+        ped->SetKinematicsIndex(slot);
+        _peds[slot] = ped;
+        Store(slot, *ped);
+    }
+}
+
+void AgentsKinematics::Store(std::size_t slot, const Pedestrian & ped)
+{
+    const JEllipse & ellipse = ped.GetEllipse();
+    const Point & pos        = ellipse.GetCenter();
+    const Point & v          = ellipse.GetV();
+
+    _x[slot]          = pos._x;
+    _y[slot]          = pos._y;
+    _vx[slot]         = v._x;
+    _vy[slot]         = v._y;
+    _v0[slot]         = ellipse.GetV0();
+    _radius[slot]     = ellipse.GetBmax();
+    _id[slot]         = ped.GetID();
+    _roomID[slot]     = ped.GetRoomID();
+    _subRoomID[slot]  = ped.GetSubRoomID();
+    _subRoomUID[slot] = ped.GetSubRoomUID();
+    _room[slot]       = ped.GetRoom();
+    _subRoom[slot]    = ped.GetSubRoom();
+}
+
+void AgentsKinematics::Clear()
+{
+    Resize(0);
+}
+
+void AgentsKinematics::Resize(std::size_t size)
+{
+    _x.resize(size);
+    _y.resize(size);
+    _vx.resize(size);
+    _vy.resize(size);
+    _v0.resize(size);
+    _radius.resize(size);
+    _id.resize(size);
+    _roomID.resize(size);
+    _subRoomID.resize(size);
+    _subRoomUID.resize(size);
+    _room.resize(size);
+    _subRoom.resize(size);
+    _peds.resize(size);
+}
@@ -0,0 +1,110 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Structure-of-arrays store for the kinematic state of all agents.
+ *
+ **/
+#pragma once
+
+#include "geometry/Point.h"
+
+#include <cstddef>
+#include <vector>
+
+class Pedestrian;
+class Room;
+class SubRoom;
+
+/**
+ * Contiguous copy of the per agent data the operational models touch in their inner loops.
+ *
+ * Slot i mirrors the i-th entry of Building::GetAllPedestrians(). The store is filled with
+ * Gather() every time the linked cells are updated and each Pedestrian remembers its slot, so the
+ * models can read positions, velocities and shapes of the neighbours from a few dense arrays
+ * instead of chasing pointers into the Pedestrian objects.
+ */
+class AgentsKinematics
+{
+public:
+    /// x-coordinate of the position
+    std::vector<double> _x;
+    /// y-coordinate of the position
+    std::vector<double> _y;
+    /// x-component of the velocity
+    std::vector<double> _vx;
+    /// y-component of the velocity
+    std::vector<double> _vy;
+    /// desired speed on the horizontal plane
+    std::vector<double> _v0;
+    /// radius of the agent, i.e. the semi-axis of the ellipse in shoulder direction (Bmax)
+    std::vector<double> _radius;
+    std::vector<int> _id;
+    std::vector<int> _roomID;
+    std::vector<int> _subRoomID;
+    std::vector<int> _subRoomUID;
+    /// room and subroom of the agent, see Pedestrian::GetRoom() and Pedestrian::GetSubRoom()
+    std::vector<Room *> _room;
+    std::vector<SubRoom *> _subRoom;
+    /// the owning pedestrian of each slot
+    std::vector<Pedestrian *> _peds;
+
+    AgentsKinematics()                         = default;
+    AgentsKinematics(const AgentsKinematics &) = default;
+    AgentsKinematics(AgentsKinematics &&)      = default;
+    AgentsKinematics & operator=(const AgentsKinematics &) = default;
+    AgentsKinematics & operator=(AgentsKinematics &&) = default;
+
+    /**
+     * Copies the kinematic state of \p peds into the store. Afterwards slot i belongs to peds[i]
+     * and every pedestrian knows its slot, see Pedestrian::GetKinematicsIndex().
+     * @param peds all pedestrians in the simulation
+     */
+    void Gather(const std::vector<Pedestrian *> & peds);
+
+    /**
+     * Copies the kinematic state of \p ped into \p slot. Used by the models to write back the
+     * state after the update step.
+     * @param slot index in the store
+     * @param ped pedestrian belonging to \p slot
+     */
+    void Store(std::size_t slot, const Pedestrian & ped);
+
+    /**
+     * Removes all entries from the store.
+     */
+    void Clear();
+
+    std::size_t Size() const { return _x.size(); }
+    bool Empty() const { return _x.empty(); }
+
+    Point GetPos(std::size_t slot) const { return Point(_x[slot], _y[slot]); }
+    Point GetV(std::size_t slot) const { return Point(_vx[slot], _vy[slot]); }
+
+    /**
+     * @return the same identifier as Pedestrian::GetUniqueRoomID() for the agent in \p slot
+     */
+    int GetUniqueRoomID(std::size_t slot) const
+    {
+        return _roomID[slot] * 1000 + _subRoomID[slot];
+    }
+
+private:
+    void Resize(std::size_t size);
+};
@@ -143,13 +143,11 @@ void AgentsSourcesManager::InitFixedPosition(AgentsSource * src, std::vector<Ped
 void AgentsSourcesManager::AdjustVelocityByNeighbour(Pedestrian * ped) const
 {
     //get the density
-    std::vector<Pedestrian *> neighbours = _building->GetNeighborhoodSearch().GetNeighbourhood(ped);
-
     double speed         = 0.0;
     double radius_square = 0.56 * 0.56; //corresponding to an area of 1m3
     int count            = 0;
 
-    for(const auto & p : neighbours) {
+    _building->GetNeighborhoodSearch().ForEachNeighbour(ped, [&](const Pedestrian * p) {
         //only pedestrians in a specific range
         if((ped->GetPos() - p->GetPos()).NormSquare() <= radius_square) {
             //only peds with the same destination
@@ -163,7 +161,7 @@ void AgentsSourcesManager::AdjustVelocityByNeighbour(Pedestrian * ped) const
                 }
             }
         }
-    }
+    });
     //mean speed
     if(count == 0) {
         speed = ped->GetEllipse().GetV0(); // FIXME:  bad fix for: peds without navline (ar.graf)
@@ -190,17 +188,15 @@ void AgentsSourcesManager::AdjustVelocityByNeighbour(Pedestrian * ped) const
 void AgentsSourcesManager::AdjustVelocityUsingWeidmann(Pedestrian * ped) const
 {
     //get the density
-    std::vector<Pedestrian *> neighbours = _building->GetNeighborhoodSearch().GetNeighbourhood(ped);
-
     //density in pers per m2
     double density = 1.0;
     //radius corresponding to a surface of 1m2
     double radius_square = 1.0;
 
-    for(const auto & p : neighbours) {
+    _building->GetNeighborhoodSearch().ForEachNeighbour(ped, [&](const Pedestrian * p) {
         if((ped->GetPos() - p->GetPos()).NormSquare() <= radius_square)
             density += 1.0;
-    }
+    });
     density = density / (radius_square * M_PI);
 
     //get the velocity
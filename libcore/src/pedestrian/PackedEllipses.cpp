@@ -0,0 +1,278 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "PackedEllipses.h"
+
+#include "Ellipse.h"
+#include "general/Macros.h"
+
+#include <cmath>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/*
+ * The kernel is written once for double and for the vector types. The overloads below map the
+ * arithmetic to the scalar operators or to the intrinsics, the comparison returns a bool or a
+ * lane mask.
+ */
+inline double Add(double a, double b)
+{
+    return a + b;
+}
+inline double Sub(double a, double b)
+{
+    return a - b;
+}
+inline double Mul(double a, double b)
+{
+    return a * b;
+}
+inline double Div(double a, double b)
+{
+    return a / b;
+}
+inline double Sqrt(double a)
+{
+    return sqrt(a);
+}
+inline bool NotLess(double a, double b)
+{
+    return !(a < b);
+}
+inline double Select(bool mask, double a, double b)
+{
+    return mask ? a : b;
+}
+
+#if defined(__AVX__)
+// the vector type is wrapped, as a template argument of Ellipses it would lose its attributes
+struct Pack {
+    __m256d v;
+};
+constexpr std::size_t PACK_SIZE = 4;
+
+inline Pack Add(Pack a, Pack b)
+{
+    return {_mm256_add_pd(a.v, b.v)};
+}
+inline Pack Sub(Pack a, Pack b)
+{
+    return {_mm256_sub_pd(a.v, b.v)};
+}
+inline Pack Mul(Pack a, Pack b)
+{
+    return {_mm256_mul_pd(a.v, b.v)};
+}
+inline Pack Div(Pack a, Pack b)
+{
+    return {_mm256_div_pd(a.v, b.v)};
+}
+inline Pack Sqrt(Pack a)
+{
+    return {_mm256_sqrt_pd(a.v)};
+}
+inline Pack NotLess(Pack a, Pack b)
+{
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_NLT_UQ)};
+}
+inline Pack Select(Pack mask, Pack a, Pack b)
+{
+    return {_mm256_blendv_pd(b.v, a.v, mask.v)};
+}
+inline Pack Load(const double * p)
+{
+    return {_mm256_loadu_pd(p)};
+}
+inline Pack Broadcast(double v)
+{
+    return {_mm256_set1_pd(v)};
+}
+inline void Store(double * p, Pack value)
+{
+    _mm256_storeu_pd(p, value.v);
+}
+#elif defined(__SSE2__)
+// the vector type is wrapped, as a template argument of Ellipses it would lose its attributes
+struct Pack {
+    __m128d v;
+};
+constexpr std::size_t PACK_SIZE = 2;
+
+inline Pack Add(Pack a, Pack b)
+{
+    return {_mm_add_pd(a.v, b.v)};
+}
+inline Pack Sub(Pack a, Pack b)
+{
+    return {_mm_sub_pd(a.v, b.v)};
+}
+inline Pack Mul(Pack a, Pack b)
+{
+    return {_mm_mul_pd(a.v, b.v)};
+}
+inline Pack Div(Pack a, Pack b)
+{
+    return {_mm_div_pd(a.v, b.v)};
+}
+inline Pack Sqrt(Pack a)
+{
+    return {_mm_sqrt_pd(a.v)};
+}
+inline Pack NotLess(Pack a, Pack b)
+{
+    return {_mm_cmpnlt_pd(a.v, b.v)};
+}
+inline Pack Select(Pack mask, Pack a, Pack b)
+{
+    // no blend in SSE2
+    return {_mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v))};
+}
+inline Pack Load(const double * p)
+{
+    return {_mm_loadu_pd(p)};
+}
+inline Pack Broadcast(double v)
+{
+    return {_mm_set1_pd(v)};
+}
+inline void Store(double * p, Pack value)
+{
+    _mm_storeu_pd(p, value.v);
+}
+#endif
+
+template <typename T>
+struct Ellipses {
+    T x;
+    T y;
+    T cosPhi;
+    T sinPhi;
+    T ea;
+    T eb;
+};
+
+/*
+ * Distance from the centre of E to the point of E in direction (px, py), given in the coordinates
+ * of E. Same operations as JEllipse::PointOnEllipse() followed by (centre - R).Norm().
+ */
+template <typename T>
+T Radius(const Ellipses<T> & E, T px, T py, T zero, T epsSquare)
+{
+    const T r2 = Add(Mul(px, px), Mul(py, py));
+    // a point at the centre is projected to (a, 0)
+    const auto valid = NotLess(r2, epsSquare);
+    const T r        = Sqrt(r2);
+    const T sx       = Select(valid, Mul(E.ea, Div(px, r)), E.ea);
+    const T sy       = Select(valid, Mul(E.eb, Div(py, r)), zero);
+    // TransformToCartesianCoordinates()
+    const T rx = Add(Sub(Mul(sx, E.cosPhi), Mul(sy, E.sinPhi)), E.x);
+    const T ry = Add(Add(Mul(sx, E.sinPhi), Mul(sy, E.cosPhi)), E.y);
+    const T dx = Sub(E.x, rx);
+    const T dy = Sub(E.y, ry);
+    return Sqrt(Add(Mul(dx, dx), Mul(dy, dy)));
+}
+
+/*
+ * Same operations as JEllipse::EffectiveDistanceToEllipse(). TransformToEllipseCoordinates()
+ * rotates by (cosPhi, -sinPhi), x * cosPhi - y * (-sinPhi) is written as x * cosPhi + y * sinPhi
+ * and x * (-sinPhi) + y * cosPhi as y * cosPhi - x * sinPhi, both are exactly the same.
+ */
+template <typename T>
+T EffectiveDistance(const Ellipses<T> & E1, const Ellipses<T> & E2, T zero, T epsSquare)
+{
+    // centre of E2 in the coordinates of E1
+    const T dx21 = Sub(E2.x, E1.x);
+    const T dy21 = Sub(E2.y, E1.y);
+    const T u1   = Add(Mul(dx21, E1.cosPhi), Mul(dy21, E1.sinPhi));
+    const T v1   = Sub(Mul(dy21, E1.cosPhi), Mul(dx21, E1.sinPhi));
+    // centre of E1 in the coordinates of E2
+    const T dx12 = Sub(E1.x, E2.x);
+    const T dy12 = Sub(E1.y, E2.y);
+    const T u2   = Add(Mul(dx12, E2.cosPhi), Mul(dy12, E2.sinPhi));
+    const T v2   = Sub(Mul(dy12, E2.cosPhi), Mul(dx12, E2.sinPhi));
+
+    const T dist = Sqrt(Add(Mul(dx12, dx12), Mul(dy12, dy12)));
+    return Sub(
+        Sub(dist, Radius(E1, u1, v1, zero, epsSquare)), Radius(E2, u2, v2, zero, epsSquare));
+}
+} // namespace
+
+void PackedEllipses::Add(const JEllipse & E, std::size_t index)
+{
+    _x.push_back(E.GetCenter()._x);
+    _y.push_back(E.GetCenter()._y);
+    _cosPhi.push_back(E.GetCosPhi());
+    _sinPhi.push_back(E.GetSinPhi());
+    _ea.push_back(E.GetEA());
+    _eb.push_back(E.GetEB());
+    _index.push_back(index);
+}
+
+void PackedEllipses::Clear()
+{
+    _x.clear();
+    _y.clear();
+    _cosPhi.clear();
+    _sinPhi.clear();
+    _ea.clear();
+    _eb.clear();
+    _index.clear();
+}
+
+void PackedEllipses::EffectiveDistances(const JEllipse & E, std::vector<double> & distances) const
+{
+    const std::size_t size = _x.size();
+    distances.resize(size);
+
+    const Ellipses<double> E1{
+        E.GetCenter()._x, E.GetCenter()._y, E.GetCosPhi(), E.GetSinPhi(), E.GetEA(), E.GetEB()};
+    const double epsSquare = J_EPS * J_EPS;
+
+    std::size_t i = 0;
+#if defined(__AVX__) || defined(__SSE2__)
+    const Ellipses<Pack> E1Lanes{
+        Broadcast(E1.x),
+        Broadcast(E1.y),
+        Broadcast(E1.cosPhi),
+        Broadcast(E1.sinPhi),
+        Broadcast(E1.ea),
+        Broadcast(E1.eb)};
+    const Pack zeroLanes      = Broadcast(0.);
+    const Pack epsSquareLanes = Broadcast(epsSquare);
+    for(; i + PACK_SIZE <= size; i += PACK_SIZE) {
+        const Ellipses<Pack> E2{
+            Load(&_x[i]),
+            Load(&_y[i]),
+            Load(&_cosPhi[i]),
+            Load(&_sinPhi[i]),
+            Load(&_ea[i]),
+            Load(&_eb[i])};
+        Store(&distances[i], EffectiveDistance(E1Lanes, E2, zeroLanes, epsSquareLanes));
+    }
+#endif
+    for(; i < size; ++i) {
+        const Ellipses<double> E2{_x[i], _y[i], _cosPhi[i], _sinPhi[i], _ea[i], _eb[i]};
+        distances[i] = EffectiveDistance(E1, E2, 0., epsSquare);
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Ellipses of the neighbours of one pedestrian stored as structure of arrays.
+ *
+ **/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class JEllipse;
+
+/**
+ * Ellipses stored as structure of arrays for the effective distance of the GCFM.
+ *
+ * JEllipse::EffectiveDistanceToEllipse() transforms both centres into the other ellipse, projects
+ * them onto the ellipses and measures the radii. EffectiveDistances() repeats these operations for
+ * one ellipse against all stored ones, so its results are bitwise those of JEllipse. The kernel
+ * takes four ellipses per AVX or two per SSE2 register if the build enables them, the remaining
+ * ellipses are done with double. Clear() does not free the arrays, the GCFM fills the same object
+ * with the neighbours of one pedestrian after the other.
+ */
+class PackedEllipses
+{
+private:
+    /// centre, orientation and semi-axes of the ellipses
+    std::vector<double> _x;
+    std::vector<double> _y;
+    std::vector<double> _cosPhi;
+    std::vector<double> _sinPhi;
+    std::vector<double> _ea;
+    std::vector<double> _eb;
+    /// index of the ellipse given to Add()
+    std::vector<std::size_t> _index;
+
+public:
+    /**
+     * Appends an ellipse.
+     * @param E the ellipse, the semi-axes are evaluated for its current velocity
+     * @param index index of the ellipse, e.g. the slot of its pedestrian in the AgentsKinematics
+     */
+    void Add(const JEllipse & E, std::size_t index);
+
+    /**
+     * Removes all ellipses, the capacity is kept.
+     */
+    void Clear();
+
+    /**
+     * @return the number of ellipses
+     */
+    std::size_t Size() const { return _x.size(); }
+
+    /**
+     * @param n position of the ellipse in this object
+     * @return the index given to Add()
+     */
+    std::size_t GetIndex(std::size_t n) const { return _index[n]; }
+
+    /**
+     * Computes E.EffectiveDistanceToEllipse() for all stored ellipses.
+     * @param E the ellipse
+     * @param distances receives the effective distance to ellipse n at position n
+     */
+    void EffectiveDistances(const JEllipse & E, std::vector<double> & distances) const;
+};
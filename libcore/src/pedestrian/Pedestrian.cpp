@@ -28,7 +28,9 @@
 
 #include "JPSfire/generic/FDSMeshStorage.h"
 #include "Knowledge.h"
+#include "PedestrianPool.h"
 #include "geometry/Building.h"
+#include "geometry/Room.h"
 #include "geometry/SubRoom.h"
 #include "geometry/WaitingArea.h"
 
@@ -165,6 +167,32 @@ Pedestrian::~Pedestrian()
     delete _navLine;
 }
 
+void * Pedestrian::operator new(std::size_t size)
+{
+    // derived classes have a different size and use the default allocation
+    if(size != sizeof(Pedestrian)) {
+        return ::operator new(size);
+    }
+    return GetPool().Allocate();
+}
+
+void Pedestrian::operator delete(void * ptr, std::size_t size)
+{
+    if(size != sizeof(Pedestrian)) {
+        ::operator delete(ptr);
+        return;
+    }
+    GetPool().Free(ptr);
+}
+
+PedestrianPool & Pedestrian::GetPool()
+{
+    static_assert(alignof(Pedestrian) <= alignof(std::max_align_t));
+    // never destroyed, pedestrians may be deleted during static destruction
+    static auto * pool = new PedestrianPool(sizeof(Pedestrian));
+    return *pool;
+}
+
 
 void Pedestrian::SetID(int i)
 {
@@ -177,11 +205,13 @@ void Pedestrian::SetID(int i)
 void Pedestrian::SetRoomID(int i)
 {
     _roomID = i;
+    UpdateRoomPointers();
 }
 
 void Pedestrian::SetSubRoomID(int i)
 {
     _subRoomID = i;
+    UpdateRoomPointers();
 }
 
 void Pedestrian::SetSubRoomUID(int i)
@@ -237,13 +267,6 @@ void Pedestrian::SetV(const Point & v)
 {
     if(_globalTime >= _premovement) {
         _ellipse.SetV(v);
-        //save the last values for the records
-        _lastVelocites.push(v);
-
-        unsigned int max_size = _recordingTime / _deltaT;
-        if(_lastVelocites.size() > max_size) {
-            _lastVelocites.pop();
-        }
     }
 }
 
@@ -299,6 +322,16 @@ int Pedestrian::GetRoomID() const
     return _roomID;
 }
 
+Room * Pedestrian::GetRoom() const
+{
+    return _room;
+}
+
+SubRoom * Pedestrian::GetSubRoom() const
+{
+    return _subRoom;
+}
+
 int Pedestrian::GetSubRoomID() const
 {
     return _subRoomID;
@@ -436,7 +469,7 @@ double Pedestrian::GetV0Norm() const
 {
     // @todo: we need to know the difference of the ped_elevation to the old_nav_elevation, and use this in the function f.
     //detect the walking direction based on the elevation
-    SubRoom * sub        = _building->GetRoom(_roomID)->GetSubRoom(_subRoomID);
+    SubRoom * sub        = _subRoom;
     double ped_elevation = sub->GetElevation(_ellipse.GetCenter());
     if(_navLine == nullptr) {
         LOG_ERROR("ped {:d} has no navline", _id);
@@ -692,6 +725,11 @@ void Pedestrian::SetRouter(Router * router)
     _routingStrategy = router->GetStrategy();
 }
 
+Router * Pedestrian::GetRouter() const
+{
+    return _router;
+}
+
 int Pedestrian::FindRoute()
 {
     if(_router == nullptr) {
@@ -703,7 +741,7 @@ int Pedestrian::FindRoute()
 
 double Pedestrian::GetElevation() const
 {
-    return _building->GetRoom(_roomID)->GetSubRoom(_subRoomID)->GetElevation(GetPos());
+    return _subRoom->GetElevation(GetPos());
 }
 
 void Pedestrian::SetGlobalTime(double time)
@@ -763,6 +801,7 @@ const Building * Pedestrian::GetBuilding()
 void Pedestrian::SetBuilding(Building * building)
 {
     _building = building;
+    UpdateRoomPointers();
 }
 
 void Pedestrian::SetWalkingSpeed(std::shared_ptr<WalkingSpeed> walkingSpeed)
@@ -916,6 +955,28 @@ void Pedestrian::UpdateRoom(int roomID, int subRoomID)
     _oldSubRoomID = _subRoomID;
     _roomID       = roomID;
     _subRoomID    = subRoomID;
+    UpdateRoomPointers();
+}
+
+void Pedestrian::UpdateRoomPointers()
+{
+    // no logging, the IDs are set one by one and may not match a subroom in between
+    _room    = nullptr;
+    _subRoom = nullptr;
+    if(_building == nullptr) {
+        return;
+    }
+    const auto & rooms = _building->GetAllRooms();
+    const auto room    = rooms.find(_roomID);
+    if(room == std::end(rooms)) {
+        return;
+    }
+    _room                 = room->second.get();
+    const auto & subrooms = _room->GetAllSubRooms();
+    const auto subroom    = subrooms.find(_subRoomID);
+    if(subroom != std::end(subrooms)) {
+        _subRoom = subroom->second.get();
+    }
 }
 
 const std::queue<Point> & Pedestrian::GetLastPositions() const
@@ -928,6 +989,16 @@ Point Pedestrian::GetLastPosition() const
     return _lastPosition;
 }
 
+void Pedestrian::SetKinematicsIndex(std::size_t index)
+{
+    _kinematicsIndex = index;
+}
+
+std::size_t Pedestrian::GetKinematicsIndex() const
+{
+    return _kinematicsIndex;
+}
+
 std::string Pedestrian::ToString() const
 {
     std::string message = fmt::format(
@@ -35,6 +35,7 @@
 #include "geometry/NavLine.h"
 #include "pedestrian/Knowledge.h"
 
+#include <cstddef>
 #include <map>
 #include <queue>
 #include <set>
@@ -42,7 +43,10 @@
 
 class Building;
 class NavLine;
+class PedestrianPool;
+class Room;
 class Router;
+class SubRoom;
 class WalkingSpeed;
 class Pedestrian
 {
@@ -75,6 +79,9 @@ private:
     int _subRoomUID;
     int _oldRoomID;
     int _oldSubRoomID;
+    /// room and subroom with the IDs above, nullptr if they do not exist in _building
+    Room * _room       = nullptr;
+    SubRoom * _subRoom = nullptr;
     Point _lastE0;
 
     NavLine * _navLine;            // current exit line
@@ -98,8 +105,6 @@ private:
     double _recordingTime;
     /// store the last positions
     std::queue<Point> _lastPositions;
-    /// store the last velocities
-    std::queue<Point> _lastVelocites;
     /// routing strategy followed
     RoutingStrategy _routingStrategy;
 
@@ -131,6 +136,9 @@ private:
     bool _waiting    = false;
     Point _waitingPos;
 
+    /// slot of this pedestrian in the kinematics store of the building
+    std::size_t _kinematicsIndex = 0;
+
 public:
     // constructors
     Pedestrian();
@@ -138,6 +146,18 @@ public:
     explicit Pedestrian(const StartDistribution & agentsParameters, Building & building);
     virtual ~Pedestrian();
 
+    /**
+     * Pedestrians created with new are allocated from GetPool(), so the memory of removed agents
+     * is reused by the agents created later on.
+     */
+    static void * operator new(std::size_t size);
+    static void operator delete(void * ptr, std::size_t size);
+
+    /**
+     * @return the pool all pedestrians are allocated from
+     */
+    static PedestrianPool & GetPool();
+
     // Setter-Funktionen
     void SetID(int i);
     void SetRoomID(int i);
@@ -180,6 +200,10 @@ public:
     int GetRoomID() const;
     int GetSubRoomID() const;
     int GetSubRoomUID() const;
+    /// @return the room with GetRoomID(), nullptr if it does not exist
+    Room * GetRoom() const;
+    /// @return the subroom with GetRoomID() and GetSubRoomID(), nullptr if it does not exist
+    SubRoom * GetSubRoom() const;
     double GetMass() const;
     double GetTau() const;
     const JEllipse & GetEllipse() const;
@@ -219,6 +243,7 @@ public:
     std::string GetKnowledgeAsString() const;
 
     RoutingStrategy GetRoutingStrategy() const;
+    Router * GetRouter() const;
     int GetUniqueRoomID() const;
     int GetNextDestination();
     double GetDistanceToNextTarget() const;
@@ -419,6 +444,13 @@ public:
      */
     void UpdateRoom(int roomID, int subRoomID);
 
+    /**
+     * Looks up the room and subroom returned by GetRoom() and GetSubRoom() in the building again.
+     * Setting the room, subroom or building does this automatically, it is only needed after
+     * the rooms of the building were replaced.
+     */
+    void UpdateRoomPointers();
+
     /**
      * Checks if between the last two calls of 'UpdateRoom(int, int)' the Room of the pedestrian
      * has changed.
@@ -441,6 +473,20 @@ public:
     const std::queue<Point> & GetLastPositions() const;
 
     Point GetLastPosition() const;
+
+    /**
+     * Set/Get the slot of the pedestrian in the AgentsKinematics store of the building.
+     * The slot is only valid between a call to Building::UpdateGrid() and the next change of
+     * the pedestrians in the building.
+     */
+    void SetKinematicsIndex(std::size_t index);
+
+    /**
+     * Set/Get the slot of the pedestrian in the AgentsKinematics store of the building.
+     * The slot is only valid between a call to Building::UpdateGrid() and the next change of
+     * the pedestrians in the building.
+     */
+    std::size_t GetKinematicsIndex() const;
 };
 
 std::ostream & operator<<(std::ostream & out, const Pedestrian & pedestrian);
@@ -0,0 +1,81 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "PedestrianPool.h"
+
+#include <algorithm>
+
+PedestrianPool::PedestrianPool(std::size_t slotSize, std::size_t slotsPerSlab) :
+    _slotsPerSlab(std::max<std::size_t>(slotsPerSlab, 1))
+{
+    // every slot has to hold the free list link and keep the alignment of its successor
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    slotSize                        = std::max(slotSize, sizeof(FreeSlot));
+    _slotSize                       = (slotSize + alignment - 1) / alignment * alignment;
+}
+
+void * PedestrianPool::Allocate()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_freeSlots == nullptr) {
+        AddSlab();
+    }
+    FreeSlot * slot = _freeSlots;
+    _freeSlots      = slot->next;
+    ++_used;
+    return slot;
+}
+
+void PedestrianPool::Free(void * ptr)
+{
+    if(ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto * slot = static_cast<FreeSlot *>(ptr);
+    slot->next  = _freeSlots;
+    _freeSlots  = slot;
+    --_used;
+}
+
+std::size_t PedestrianPool::Capacity() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _slabs.size() * _slotsPerSlab;
+}
+
+std::size_t PedestrianPool::Used() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _used;
+}
+
+void PedestrianPool::AddSlab()
+{
+    _slabs.emplace_back(new std::byte[_slotSize * _slotsPerSlab]);
+    std::byte * slab = _slabs.back().get();
+
+    // link the slots back to front, so they are handed out in memory order
+    for(std::size_t i = _slotsPerSlab; i > 0; --i) {
+        auto * slot = reinterpret_cast<FreeSlot *>(slab + (i - 1) * _slotSize);
+        slot->next  = _freeSlots;
+        _freeSlots  = slot;
+    }
+}
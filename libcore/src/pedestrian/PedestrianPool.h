@@ -0,0 +1,85 @@
+/**
+ * \copyright   <2009-2020> Forschungszentrum Jülich GmbH. All rights reserved.
+ *
+ * \section License
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \section Description
+ * Slab allocator for Pedestrian objects.
+ *
+ **/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Hands out fixed size memory slots for pedestrians.
+ *
+ * Memory is requested in slabs of many slots at once and is kept until the pool is destroyed.
+ * Freed slots go into a free list and are handed out again to the next agents, e.g. the agents
+ * created by the sources. The slot freed last is reused first, so new agents land in memory that
+ * is most likely still cached.
+ */
+class PedestrianPool
+{
+public:
+    /**
+     * @param slotSize size of one slot in bytes
+     * @param slotsPerSlab number of slots allocated at once when the pool runs empty
+     */
+    explicit PedestrianPool(std::size_t slotSize, std::size_t slotsPerSlab = 1024);
+    PedestrianPool(const PedestrianPool &) = delete;
+    PedestrianPool & operator=(const PedestrianPool &) = delete;
+    ~PedestrianPool()                                  = default;
+
+    /**
+     * @return uninitialized memory of at least the slot size, aligned for any scalar type
+     */
+    void * Allocate();
+
+    /**
+     * Returns a slot to the pool.
+     * @param ptr memory obtained from Allocate() of this pool
+     */
+    void Free(void * ptr);
+
+    /**
+     * @return number of slots in all slabs
+     */
+    std::size_t Capacity() const;
+
+    /**
+     * @return number of slots currently handed out
+     */
+    std::size_t Used() const;
+
+private:
+    struct FreeSlot {
+        FreeSlot * next;
+    };
+
+    void AddSlab();
+
+    std::size_t _slotSize;
+    std::size_t _slotsPerSlab;
+    std::vector<std::unique_ptr<std::byte[]>> _slabs;
+    FreeSlot * _freeSlots = nullptr;
+    std::size_t _used     = 0;
+    mutable std::mutex _mutex;
+};
@@ -109,6 +109,14 @@ public:
       */
     virtual int FindExit(Pedestrian * p) = 0;
 
+    /**
+      * A reentrant router allows FindExit() to be called for different pedestrians at the same
+      * time. FindExit() then only reads the router and the building, writes nothing but the
+      * pedestrian it is called for and keeps its scratch data on the stack of the calling thread.
+      * @return true if FindExit() may be called concurrently, false by default
+      */
+    virtual bool IsReentrant() const { return false; }
+
     /**
       * Each implementation of this virtual class has the possibility to initialize
       * its Routing engine using the supplied building object.
@@ -361,7 +361,7 @@ int FFRouter::FindExit(Pedestrian * p)
 {
     if(_strategy == ROUTING_FF_QUICKEST) {
         if(Pedestrian::GetGlobalTime() > _recalculationInterval &&
-           _building->GetRoom(p->GetRoomID())->GetSubRoom(p->GetSubRoomID())->IsInSubRoom(p) &&
+           p->GetSubRoom()->IsInSubRoom(p) &&
            _floorfieldByRoomID[p->GetRoomID()]->GetCostToDestination(
                p->GetExitIndex(), p->GetPos()) > 3.0 &&
            p->GetExitIndex() != -1) {
@@ -426,26 +426,23 @@ int FFRouter::FindExit(Pedestrian * p)
 
     if(!_targetWithinSubroom) {
         //candidates of current room (ID) (provided by Room)
-        for(auto transUID : _building->GetRoom(p->GetRoomID())->GetAllTransitionsIDs()) {
+        for(auto transUID : p->GetRoom()->GetAllTransitionsIDs()) {
             if(_doorByUID.count(transUID) != 0) {
                 DoorUIDsOfRoom.emplace_back(transUID);
             }
         }
-        for(auto & subIPair : _building->GetRoom(p->GetRoomID())->GetAllSubRooms()) {
+        for(auto & subIPair : p->GetRoom()->GetAllSubRooms()) {
             for(auto & crossI : subIPair.second->GetAllCrossings()) {
                 DoorUIDsOfRoom.emplace_back(crossI->GetUniqueID());
             }
         }
     } else {
         //candidates of current subroom only
-        for(auto & crossI :
-            _building->GetRoom(p->GetRoomID())->GetSubRoom(p->GetSubRoomID())->GetAllCrossings()) {
+        for(auto & crossI : p->GetSubRoom()->GetAllCrossings()) {
             DoorUIDsOfRoom.emplace_back(crossI->GetUniqueID());
         }
 
-        for(auto & transI : _building->GetRoom(p->GetRoomID())
-                                ->GetSubRoom(p->GetSubRoomID())
-                                ->GetAllTransitions()) {
+        for(auto & transI : p->GetSubRoom()->GetAllTransitions()) {
             if(transI->IsOpen() || transI->IsTempClose()) {
                 DoorUIDsOfRoom.emplace_back(transI->GetUniqueID());
             }
@@ -480,9 +477,9 @@ int FFRouter::FindExit(Pedestrian * p)
                     bestDoor = key.first; //doorUID
                     auto subroomDoors =
                         _building->GetSubRoomByUID(p->GetSubRoomUID())->GetAllGoalIDs();
-                    if(std::find(subroomDoors.begin(), subroomDoors.end(), _pathsMatrix[key]) !=
+                    if(std::find(subroomDoors.begin(), subroomDoors.end(), _pathsMatrix.at(key)) !=
                        subroomDoors.end()) {
-                        bestDoor = _pathsMatrix[key]; //@todo: @ar.graf: check this hack
+                        bestDoor = _pathsMatrix.at(key); //@todo: @ar.graf: check this hack
                     }
                     bestFinalDoor = key.second;
                 }
@@ -492,9 +489,9 @@ int FFRouter::FindExit(Pedestrian * p)
 
     //at this point, bestDoor is either a crossing or a transition
     if((!_targetWithinSubroom) && (_doorByUID.count(bestDoor) != 0)) {
-        while(!_doorByUID[bestDoor]->IsTransition()) {
+        while(!_doorByUID.at(bestDoor)->IsTransition()) {
             std::pair<int, int> key = std::make_pair(bestDoor, bestFinalDoor);
-            bestDoor                = _pathsMatrix[key];
+            bestDoor                = _pathsMatrix.at(key);
         }
     }
 
@@ -127,6 +127,12 @@ public:
 
     int FindExit(Pedestrian * p) override;
 
+    /**
+      * FindExit() only reads the distance matrix and the precomputed floor fields, except for
+      * \a _strategy=ROUTING_FF_QUICKEST, which flags the router for a recalculation.
+      */
+    bool IsReentrant() const override { return _strategy != ROUTING_FF_QUICKEST; }
+
     void Update() override;
 
     /**
@@ -146,7 +146,12 @@ int AccessPoint::GetNextApTo(int UID)
 
 int AccessPoint::GetNearestTransitAPTO(int UID)
 {
-    const std::vector<AccessPoint *> & possibleDest = _navigationGraphTo[UID];
+    // no insertion for unknown destinations, the routers query this concurrently
+    auto itr = _navigationGraphTo.find(UID);
+    if(itr == _navigationGraphTo.end()) {
+        return -1;
+    }
+    const std::vector<AccessPoint *> & possibleDest = itr->second;
 
     if(possibleDest.size() == 0) {
         return -1;
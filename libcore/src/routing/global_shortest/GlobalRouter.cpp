@@ -549,6 +549,19 @@ double GlobalRouter::GetEdgeCost() const
     return _edgeCost;
 }
 
+AccessPoint * GlobalRouter::GetAccessPoint(int id) const
+{
+    auto itr = _accessPoints.find(id);
+    return itr != _accessPoints.end() ? itr->second : nullptr;
+}
+
+const std::vector<SubRoom *> & GlobalRouter::GetSubroomsAtElevation(const SubRoom & sub) const
+{
+    static const std::vector<SubRoom *> none;
+    auto itr = _subroomsAtElevation.find(sub.GetElevation(sub.GetCentroid()));
+    return itr != _subroomsAtElevation.end() ? itr->second : none;
+}
+
 void GlobalRouter::GetPath(int i, int j)
 {
     if(_distMatrix[i][j] == FLT_MAX)
@@ -567,7 +580,7 @@ bool GlobalRouter::GetPath(Pedestrian * ped, std::vector<NavLine *> & path)
     if(currentNavLine == -1) {
         currentNavLine = GetBestDefaultRandomExit(ped);
     }
-    aps_path.push_back(_accessPoints[currentNavLine]);
+    aps_path.push_back(GetAccessPoint(currentNavLine));
 
     int loop_count = 1;
     do {
@@ -577,7 +590,7 @@ bool GlobalRouter::GetPath(Pedestrian * ped, std::vector<NavLine *> & path)
         if(next_dest == -1)
             break; //we are done
 
-        auto & next_ap = _accessPoints[next_dest];
+        AccessPoint * next_ap = GetAccessPoint(next_dest);
 
         if(next_ap->GetFinalExitToOutside()) {
             done = true;
@@ -641,7 +654,7 @@ bool GlobalRouter::GetPath(Pedestrian * ped, int goalID, std::vector<SubRoom *>
 
     for(unsigned int i = 0; i < _tmpPedPath.size(); i++) {
         int ap_id       = _map_index_to_id[_tmpPedPath[i]];
-        int subroom_uid = _accessPoints[ap_id]->GetConnectingRoom1();
+        int subroom_uid = GetAccessPoint(ap_id)->GetConnectingRoom1();
         if(subroom_uid == -1)
             continue;
         SubRoom * sub = _building->GetSubRoomByUID(subroom_uid);
@@ -651,7 +664,7 @@ bool GlobalRouter::GetPath(Pedestrian * ped, int goalID, std::vector<SubRoom *>
 
     for(unsigned int i = 0; i < _tmpPedPath.size(); i++) {
         int ap_id       = _map_index_to_id[_tmpPedPath[i]];
-        int subroom_uid = _accessPoints[ap_id]->GetConnectingRoom2();
+        int subroom_uid = GetAccessPoint(ap_id)->GetConnectingRoom2();
         if(subroom_uid == -1)
             continue;
         SubRoom * sub = _building->GetSubRoomByUID(subroom_uid);
@@ -706,7 +719,7 @@ int GlobalRouter::FindExit(Pedestrian * ped)
     if(!_useMeshForLocalNavigation) {
         std::vector<NavLine *> path;
         GetPath(ped, path);
-        SubRoom * sub = _building->GetRoom(ped->GetRoomID())->GetSubRoom(ped->GetSubRoomID());
+        SubRoom * sub = ped->GetSubRoom();
 
         //return the next path which is an exit
         for(const auto & navLine : path) {
@@ -737,10 +750,10 @@ int GlobalRouter::FindExit(Pedestrian * ped)
         return GetBestDefaultRandomExit(ped);
 
     } else {
-        SubRoom * sub = _building->GetRoom(ped->GetRoomID())->GetSubRoom(ped->GetSubRoomID());
+        SubRoom * sub = ped->GetSubRoom();
 
         for(const auto & apID : sub->GetAllGoalIDs()) {
-            AccessPoint * ap  = _accessPoints[apID];
+            AccessPoint * ap  = GetAccessPoint(apID);
             const Point & pt3 = ped->GetPos();
             double distToExit = ap->GetNavLine()->DistTo(pt3);
 
@@ -761,21 +774,21 @@ int GlobalRouter::FindExit(Pedestrian * ped)
                 return ped->GetNextDestination();
             } else {
                 //check that the next destination is in the actual room of the pedestrian
-                if(!_accessPoints[nextDestination]->isInRange(sub->GetUID())) {
+                if(!GetAccessPoint(nextDestination)->isInRange(sub->GetUID())) {
                     //return the last destination if defined
                     int previousDestination = ped->GetNextDestination();
 
                     //we are still somewhere in the initialization phase
                     if(previousDestination == -1) {
                         ped->SetExitIndex(apID);
-                        ped->SetExitLine(_accessPoints[apID]->GetNavLine());
+                        ped->SetExitLine(GetAccessPoint(apID)->GetNavLine());
                         return apID;
                     } else { // we are still having a valid destination, don't change
                         return previousDestination;
                     }
                 } else { // we have reached the new room
                     ped->SetExitIndex(nextDestination);
-                    ped->SetExitLine(_accessPoints[nextDestination]->GetNavLine());
+                    ped->SetExitLine(GetAccessPoint(nextDestination)->GetNavLine());
                     return nextDestination;
                 }
             }
@@ -805,7 +818,7 @@ int GlobalRouter::GetBestDefaultRandomExit(Pedestrian * ped)
     //double minDistLocal = FLT_MAX;
 
     // get the opened exits
-    SubRoom * sub = _building->GetRoom(ped->GetRoomID())->GetSubRoom(ped->GetSubRoomID());
+    SubRoom * sub = ped->GetSubRoom();
 
     for(unsigned int g = 0; g < relevantAPs.size(); g++) {
         AccessPoint * ap = relevantAPs[g];
@@ -825,8 +838,7 @@ int GlobalRouter::GetBestDefaultRandomExit(Pedestrian * ped)
         //check if visible
         //only if the room is convex
         //otherwise check all rooms at that level
-        if(!_building->IsVisible(
-               posA, posC, _subroomsAtElevation[sub->GetElevation(sub->GetCentroid())], true)) {
+        if(!_building->IsVisible(posA, posC, GetSubroomsAtElevation(*sub), true)) {
             ped->RerouteIn(10);
             continue;
         }
@@ -843,7 +855,7 @@ int GlobalRouter::GetBestDefaultRandomExit(Pedestrian * ped)
 
     if(bestAPsID != -1) {
         ped->SetExitIndex(bestAPsID);
-        ped->SetExitLine(_accessPoints[bestAPsID]->GetNavLine());
+        ped->SetExitLine(GetAccessPoint(bestAPsID)->GetNavLine());
         return bestAPsID;
     } else {
         if(_building->GetRoom(ped->GetRoomID())->GetCaption() != "outside" &&
@@ -885,7 +897,7 @@ void GlobalRouter::GetRelevantRoutesTofinalDestination(
         //filter to keep only the emergencies exits.
 
         for(unsigned int g1 = 0; g1 < goals.size(); g1++) {
-            AccessPoint * ap = _accessPoints[goals[g1]];
+            AccessPoint * ap = GetAccessPoint(goals[g1]);
             bool relevant    = true;
             for(unsigned int g2 = 0; g2 < goals.size(); g2++) {
                 if(goals[g2] == goals[g1])
@@ -909,7 +921,7 @@ void GlobalRouter::GetRelevantRoutesTofinalDestination(
     else {
         const std::vector<int> & goals = sub->GetAllGoalIDs();
         for(unsigned int g1 = 0; g1 < goals.size(); g1++) {
-            AccessPoint * ap = _accessPoints[goals[g1]];
+            AccessPoint * ap = GetAccessPoint(goals[g1]);
 
             //check for visibility
             //the line from the current position to the centre of the nav line.
@@ -919,8 +931,7 @@ void GlobalRouter::GetRelevantRoutesTofinalDestination(
             const Point & posC = (posB - posA).Normalized() * ((posA - posB).Norm() - J_EPS) + posA;
 
             //check if visible
-            if(!_building->IsVisible(
-                   posA, posC, _subroomsAtElevation[sub->GetElevation(sub->GetCentroid())], true))
+            if(!_building->IsVisible(posA, posC, GetSubroomsAtElevation(*sub), true))
             //if (sub->IsVisible(posA, posC, true) == false)
             {
                 continue;
@@ -934,18 +945,14 @@ void GlobalRouter::GetRelevantRoutesTofinalDestination(
                     //pointing only to the one i dont see
                     //the line from the current position to the centre of the nav line.
                     // at least the line in that direction minus EPS
-                    AccessPoint * ap2   = _accessPoints[goals[g2]];
+                    AccessPoint * ap2   = GetAccessPoint(goals[g2]);
                     const Point & posA_ = ped->GetPos();
                     const Point & posB_ = ap2->GetNavLine()->GetCentre();
                     const Point & posC_ =
                         (posB_ - posA_).Normalized() * ((posA_ - posB_).Norm() - J_EPS) + posA_;
 
                     //it points to a destination that I can see anyway
-                    if(_building->IsVisible(
-                           posA_,
-                           posC_,
-                           _subroomsAtElevation[sub->GetElevation(sub->GetCentroid())],
-                           true))
+                    if(_building->IsVisible(posA_, posC_, GetSubroomsAtElevation(*sub), true))
                     //if (sub->IsVisible(posA_, posC_, true) == true)
                     {
                         relevant = false;
@@ -966,7 +973,7 @@ void GlobalRouter::GetRelevantRoutesTofinalDestination(
         //fixme: this should also never happened. But happen due to previous bugs..
         const std::vector<int> & goals = sub->GetAllGoalIDs();
         for(unsigned int g1 = 0; g1 < goals.size(); g1++) {
-            relevantAPS.push_back(_accessPoints[goals[g1]]);
+            relevantAPS.push_back(GetAccessPoint(goals[g1]));
         }
     }
 }
@@ -73,6 +73,11 @@ public:
 
     virtual int FindExit(Pedestrian * p);
 
+    /**
+      * FindExit() only reads the precomputed routing graph.
+      */
+    virtual bool IsReentrant() const { return true; }
+
     /**
       * Performs a check of the geometry and fixes if possible.
       * NOT IMPLEMENTED
@@ -155,6 +160,17 @@ protected:
     void
     GetRelevantRoutesTofinalDestination(Pedestrian * ped, std::vector<AccessPoint *> & relevantAPS);
 
+    /**
+      * Lookup without inserting, to keep the queries reentrant.
+      * @return the access point with the given id, nullptr if there is none
+      */
+    AccessPoint * GetAccessPoint(int id) const;
+
+    /**
+      * @return the subrooms at the elevation of the given subroom, empty if there are none
+      */
+    const std::vector<SubRoom *> & GetSubroomsAtElevation(const SubRoom & sub) const;
+
 private:
     /**
       * Compute the intermediate paths between the two given transitions IDs
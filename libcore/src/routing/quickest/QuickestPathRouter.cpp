@@ -30,6 +30,7 @@
 #include "geometry/Wall.h"
 
 #include <Logger.h>
+#include <algorithm>
 #include <tinyxml.h>
 
 QuickestPathRouter::QuickestPathRouter() : GlobalRouter() {}
@@ -98,7 +99,7 @@ int QuickestPathRouter::FindNextExit(Pedestrian * ped)
         return GetBestDefaultRandomExit(ped);
 
     } else {
-        SubRoom * sub = _building->GetRoom(ped->GetRoomID())->GetSubRoom(ped->GetSubRoomID());
+        SubRoom * sub = ped->GetSubRoom();
 
         for(const auto & apID : sub->GetAllGoalIDs()) {
             AccessPoint * ap = _accessPoints[apID];
@@ -332,41 +333,39 @@ void QuickestPathRouter::GetQueueAtExit(
         sbr2 = nullptr;
     }
 
-    if(sbr1 && (sbr1->GetSubRoomID() == subroomToConsider)) {
-        //double closestDistance=FLT_MAX;
-        std::vector<Pedestrian *> peds;
-        _building->GetPedestrians(sbr1->GetRoomID(), sbr1->GetSubRoomID(), peds);
+    // only the pedestrians in the linked cells around the exit are candidates
+    const Point centre               = hline->GetCentre();
+    const NeighborhoodSearch & cells = _building->GetNeighborhoodSearch();
 
-        for(const auto & ped : peds) {
+    auto collectQueue = [&](const SubRoom * sbr) {
+        const std::size_t first = queue.size();
+        cells.ForEachNeighbour(centre, -1, radius, [&](Pedestrian * ped) {
+            if(ped->GetRoomID() != sbr->GetRoomID() || ped->GetSubRoomID() != sbr->GetSubRoomID())
+                return;
             if(ped->GetExitIndex() == exitID) {
                 if(ped->GetV().NormSquare() < minVel2) {
-                    double dist = (ped->GetPos() - hline->GetCentre()).NormSquare();
-                    //cout<<"suspect found 1 @ "<< dist<< " { "<< closestDistance<<" }"<<endl;
+                    double dist = (ped->GetPos() - centre).NormSquare();
                     if(dist < radius2) {
                         queue.push_back(ped);
                     }
                 }
             }
-        }
+        });
+        // same order as in Building::GetAllPedestrians()
+        std::sort(
+            std::begin(queue) + first,
+            std::end(queue),
+            [](const Pedestrian * a, const Pedestrian * b) {
+                return a->GetKinematicsIndex() < b->GetKinematicsIndex();
+            });
+    };
+
+    if(sbr1 && (sbr1->GetSubRoomID() == subroomToConsider)) {
+        collectQueue(sbr1);
     }
 
     if(sbr2 && (sbr2->GetSubRoomID() == subroomToConsider)) {
-        //double closestDistance=FLT_MAX;
-        std::vector<Pedestrian *> peds;
-        _building->GetPedestrians(sbr2->GetRoomID(), sbr2->GetSubRoomID(), peds);
-
-        for(const auto & ped : peds) {
-            if(ped->GetExitIndex() == exitID) {
-                if(ped->GetV().NormSquare() < minVel2) {
-                    double dist = (ped->GetPos() - hline->GetCentre()).NormSquare();
-                    //cout<<"distance: radius"<<dist<<":"<<radius<<endl;
-                    //cout<<"suspect found 1 @ "<< dist<< " { "<< closestDistance<<" }"<<endl;
-                    if(dist < radius2) {
-                        queue.push_back(ped);
-                    }
-                }
-            }
-        }
+        collectQueue(sbr2);
     }
 
     //cout<<"queue size:"<<queue.size()<<endl;
@@ -677,7 +676,7 @@ int QuickestPathRouter::GetBestDefaultRandomExit(Pedestrian * ped)
     double minDistLocal  = FLT_MAX;
 
     // get the opened exits
-    SubRoom * sub = _building->GetRoom(ped->GetRoomID())->GetSubRoom(ped->GetSubRoomID());
+    SubRoom * sub = ped->GetSubRoom();
 
 
     for(unsigned int g = 0; g < relevantAPs.size(); g++) {
@@ -62,6 +62,11 @@ public:
 
     virtual int FindExit(Pedestrian * ped);
 
+    /**
+      * The choice depends on the exits and positions of the other pedestrians.
+      */
+    virtual bool IsReentrant() const { return false; }
+
     virtual bool Init(Building * building);
 
 private:
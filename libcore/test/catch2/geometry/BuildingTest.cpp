@@ -0,0 +1,331 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "geometry/Building.h"
+
+#include "general/Configuration.h"
+#include "geometry/SubRoom.h"
+#include "geometry/Wall.h"
+#include "neighborhood/NeighborhoodSearch.h"
+#include "pedestrian/AgentsKinematics.h"
+#include "pedestrian/Pedestrian.h"
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+namespace
+{
+std::vector<int> GetIDs(const Building & building)
+{
+    std::vector<int> ids;
+    for(const auto * ped : building.GetAllPedestrians()) {
+        ids.push_back(ped->GetID());
+    }
+    return ids;
+}
+} // namespace
+
+TEST_CASE("geometry/Building/Pedestrians", "[geometry][Building][Pedestrians]")
+{
+    Building building;
+    for(int id = 1; id <= 5; ++id) {
+        auto * ped = new Pedestrian();
+        ped->SetID(id);
+        building.AddPedestrian(ped);
+    }
+    REQUIRE(GetIDs(building) == std::vector<int>{1, 2, 3, 4, 5});
+
+    SECTION("GetPedestrian")
+    {
+        for(int id = 1; id <= 5; ++id) {
+            REQUIRE(building.GetPedestrian(id) != nullptr);
+            REQUIRE(building.GetPedestrian(id)->GetID() == id);
+        }
+        REQUIRE(building.GetPedestrian(6) == nullptr);
+    }
+
+    SECTION("AddPedestrian ignores duplicate IDs")
+    {
+        Pedestrian duplicate;
+        duplicate.SetID(3);
+        building.AddPedestrian(&duplicate);
+        REQUIRE(building.GetAllPedestrians().size() == 5);
+        REQUIRE(building.GetPedestrian(3) != &duplicate);
+    }
+
+    SECTION("DeletePedestrian swaps with the last pedestrian")
+    {
+        Pedestrian * ped = building.GetPedestrian(2);
+        building.DeletePedestrian(ped);
+        REQUIRE(GetIDs(building) == std::vector<int>{1, 5, 3, 4});
+        REQUIRE(building.GetPedestrian(2) == nullptr);
+        REQUIRE(building.GetPedestrian(5) == building.GetAllPedestrians()[1]);
+
+        ped = building.GetPedestrian(4);
+        building.DeletePedestrian(ped);
+        REQUIRE(GetIDs(building) == std::vector<int>{1, 5, 3});
+    }
+
+    SECTION("DeletePedestrian keeps the order")
+    {
+        building.SetStableAgentOrder(true);
+        Pedestrian * ped = building.GetPedestrian(2);
+        building.DeletePedestrian(ped);
+        REQUIRE(GetIDs(building) == std::vector<int>{1, 3, 4, 5});
+        for(int id : {1, 3, 4, 5}) {
+            REQUIRE(building.GetPedestrian(id)->GetID() == id);
+        }
+    }
+
+    SECTION("DeletePedestrians does not depend on the order of the input")
+    {
+        std::vector<Pedestrian *> peds{building.GetPedestrian(4), building.GetPedestrian(1)};
+        building.DeletePedestrians(peds);
+        REQUIRE(peds.empty());
+        REQUIRE(GetIDs(building) == std::vector<int>{5, 2, 3});
+        for(int id : {2, 3, 5}) {
+            REQUIRE(building.GetPedestrian(id)->GetID() == id);
+        }
+    }
+
+    SECTION("DeletePedestrians keeps the order")
+    {
+        building.SetStableAgentOrder(true);
+        std::vector<Pedestrian *> peds{building.GetPedestrian(4), building.GetPedestrian(2)};
+        building.DeletePedestrians(peds);
+        REQUIRE(peds.empty());
+        REQUIRE(GetIDs(building) == std::vector<int>{1, 3, 5});
+        for(int id : {1, 3, 5}) {
+            REQUIRE(building.GetPedestrian(id)->GetID() == id);
+        }
+    }
+}
+
+TEST_CASE("geometry/Building/GetPedestrians", "[geometry][Building][Pedestrians]")
+{
+    Building building;
+    for(int id = 1; id <= 6; ++id) {
+        auto * ped = new Pedestrian();
+        ped->SetID(id);
+        ped->SetRoomID(id % 2);
+        ped->SetSubRoomID(id <= 3 ? 0 : 1);
+        building.AddPedestrian(ped);
+    }
+
+    auto getIDs = [&building](int room, int subroom) {
+        std::vector<Pedestrian *> peds;
+        building.GetPedestrians(room, subroom, peds);
+        std::vector<int> ids;
+        for(const auto * ped : peds) {
+            ids.push_back(ped->GetID());
+        }
+        return ids;
+    };
+
+    REQUIRE(getIDs(1, 0) == std::vector<int>{1, 3});
+    REQUIRE(getIDs(0, 0) == std::vector<int>{2});
+    REQUIRE(getIDs(1, 1) == std::vector<int>{5});
+    REQUIRE(getIDs(0, 1) == std::vector<int>{4, 6});
+    REQUIRE(getIDs(2, 0).empty());
+
+    SECTION("Deleted pedestrians are removed")
+    {
+        Pedestrian * ped = building.GetPedestrian(4);
+        building.DeletePedestrian(ped);
+        REQUIRE(getIDs(0, 1) == std::vector<int>{6});
+
+        // also if the pedestrian changed the subroom in the meantime
+        ped = building.GetPedestrian(3);
+        ped->SetSubRoomID(1);
+        std::vector<Pedestrian *> peds{ped};
+        building.DeletePedestrians(peds);
+        REQUIRE(getIDs(1, 0) == std::vector<int>{1});
+        REQUIRE(getIDs(1, 1) == std::vector<int>{5});
+
+        // pedestrians added afterwards follow the deleted ones
+        auto * added = new Pedestrian();
+        added->SetID(7);
+        added->SetRoomID(0);
+        added->SetSubRoomID(1);
+        building.AddPedestrian(added);
+        REQUIRE(getIDs(0, 1) == std::vector<int>{6, 7});
+    }
+}
+
+TEST_CASE("geometry/Building/SortPedestriansSpatially", "[geometry][Building][Pedestrians]")
+{
+    // a square room of 10 m, the grid has cells of 2.2 m
+    Configuration config;
+    Building building;
+    building.SetConfig(&config);
+    auto * room = new Room();
+    room->SetID(0);
+    auto * subroom = new NormalSubRoom();
+    subroom->SetRoomID(0);
+    subroom->SetSubRoomID(0);
+    subroom->AddWall(Wall(Point(0, 0), Point(10, 0)));
+    subroom->AddWall(Wall(Point(10, 0), Point(10, 10)));
+    subroom->AddWall(Wall(Point(10, 10), Point(0, 10)));
+    subroom->AddWall(Wall(Point(0, 10), Point(0, 0)));
+    room->AddSubRoom(subroom);
+    building.AddRoom(room);
+    building.InitGrid();
+
+    // scattered over the room, the last two share a cell with the first one
+    const std::vector<Point> positions{
+        Point(9.5, 9.5),
+        Point(0.5, 9.5),
+        Point(5.5, 0.5),
+        Point(0.5, 0.5),
+        Point(9.5, 0.5),
+        Point(3.5, 6.5),
+        Point(6.5, 3.5),
+        Point(9.2, 9.8),
+        Point(9.8, 9.2)};
+    for(std::size_t i = 0; i < positions.size(); ++i) {
+        auto * ped = new Pedestrian();
+        ped->SetID(static_cast<int>(positions.size() - i));
+        ped->SetRoomID(0);
+        ped->SetSubRoomID(0);
+        ped->SetPos(positions[i], true);
+        building.AddPedestrian(ped);
+    }
+
+    building.SortPedestriansSpatially();
+    building.UpdateGrid();
+
+    const auto & peds = building.GetAllPedestrians();
+    REQUIRE(peds.size() == positions.size());
+    const NeighborhoodSearch & grid = building.GetNeighborhoodSearch();
+    for(std::size_t n = 1; n < peds.size(); ++n) {
+        const auto previous = grid.GetMortonKey(peds[n - 1]->GetPos());
+        const auto current  = grid.GetMortonKey(peds[n]->GetPos());
+        // along the Morton curve, the pedestrians of one cell by their ID
+        REQUIRE(previous <= current);
+        if(previous == current) {
+            REQUIRE(peds[n - 1]->GetID() < peds[n]->GetID());
+        }
+    }
+    // the cell at the origin starts the curve
+    REQUIRE(peds.front()->GetPos() == Point(0.5, 0.5));
+    REQUIRE(peds.front()->GetID() == 6);
+
+    SECTION("Kinematics slots")
+    {
+        const AgentsKinematics & kinematics = building.GetKinematics();
+        for(std::size_t n = 0; n < peds.size(); ++n) {
+            REQUIRE(peds[n]->GetKinematicsIndex() == n);
+            REQUIRE(kinematics._peds[n] == peds[n]);
+            REQUIRE(kinematics.GetPos(n) == peds[n]->GetPos());
+        }
+    }
+
+    SECTION("ID lookup")
+    {
+        for(int id = 1; id <= static_cast<int>(positions.size()); ++id) {
+            REQUIRE(building.GetPedestrian(id) != nullptr);
+            REQUIRE(building.GetPedestrian(id)->GetID() == id);
+        }
+        // the index is also valid for deletions after the sort
+        Pedestrian * ped = building.GetPedestrian(3);
+        building.DeletePedestrian(ped);
+        REQUIRE(building.GetPedestrian(3) == nullptr);
+        for(int id : {1, 2, 4, 5, 6, 7, 8, 9}) {
+            REQUIRE(building.GetPedestrian(id)->GetID() == id);
+        }
+    }
+}
+
+TEST_CASE("geometry/Building/IsVisible", "[geometry][Building][IsVisible]")
+{
+    Building building;
+    NormalSubRoom sub1;
+    sub1.AddWall(Wall(Point(5, 0), Point(5, 10)));
+    NormalSubRoom sub2;
+    sub2.AddWall(Wall(Point(15, 0), Point(15, 10)));
+
+    auto checkVisibility = [&]() {
+        REQUIRE_FALSE(building.IsVisible(Point(1, 5), Point(9, 5), &sub1, &sub1));
+        REQUIRE(building.IsVisible(Point(1, 5), Point(4, 5), &sub1, &sub1));
+
+        // only the walls of both subrooms are considered
+        REQUIRE(building.IsVisible(Point(11, 5), Point(14, 5), &sub1, &sub2));
+        REQUIRE_FALSE(building.IsVisible(Point(11, 5), Point(16, 5), &sub1, &sub2));
+        REQUIRE_FALSE(building.IsVisible(Point(1, 5), Point(16, 5), &sub2, &sub1));
+        REQUIRE(building.IsVisible(Point(11, 5), Point(16, 5), &sub1, &sub1));
+    };
+
+    SECTION("all walls") { checkVisibility(); }
+
+    SECTION("wall grid")
+    {
+        sub1.UpdateWallGrid();
+        sub2.UpdateWallGrid();
+        checkVisibility();
+    }
+}
+
+TEST_CASE("geometry/Building/UID lookups", "[geometry][Building][UID]")
+{
+    Building building;
+    auto * room = new Room();
+    room->SetID(0);
+    auto * subroom = new NormalSubRoom();
+    subroom->SetRoomID(0);
+    subroom->SetSubRoomID(0);
+    room->AddSubRoom(subroom);
+    building.AddRoom(room);
+
+    auto * transition = new Transition();
+    transition->SetID(1);
+    building.AddTransition(transition);
+    auto * crossing = new Crossing();
+    crossing->SetID(2);
+    crossing->SetRoom1(room);
+    building.AddCrossing(crossing);
+    auto * hline = new Hline();
+    hline->SetID(3);
+    building.AddHline(hline);
+
+    REQUIRE(building.GetSubRoomByUID(subroom->GetUID()) == subroom);
+    REQUIRE(building.GetTransitionByUID(transition->GetUniqueID()) == transition);
+    REQUIRE(building.GetCrossingByUID(crossing->GetUniqueID()) == crossing);
+    REQUIRE(building.GetTransitionByUID(crossing->GetUniqueID()) == nullptr);
+    REQUIRE(building.GetCrossingByUID(transition->GetUniqueID()) == nullptr);
+    REQUIRE(building.GetTransOrCrossByUID(transition->GetUniqueID()) == transition);
+    REQUIRE(building.GetTransOrCrossByUID(crossing->GetUniqueID()) == crossing);
+    REQUIRE(building.GetTransOrCrossByUID(hline->GetUniqueID()) == hline);
+
+    SECTION("RemoveTransition")
+    {
+        // train events remove a copy of the stored door
+        Transition door = *transition;
+        REQUIRE(building.RemoveTransition(&door));
+        REQUIRE(building.GetTransitionByUID(transition->GetUniqueID()) == nullptr);
+        delete transition;
+    }
+
+    SECTION("Subrooms added after the room")
+    {
+        auto * late = new NormalSubRoom();
+        late->SetRoomID(0);
+        late->SetSubRoomID(1);
+        room->AddSubRoom(late);
+        REQUIRE(building.GetSubRoomByUID(late->GetUID()) == late);
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "geometry/LocationRaster.h"
+
+#include "geometry/Line.h"
+#include "geometry/Obstacle.h"
+#include "geometry/Point.h"
+#include "geometry/SubRoom.h"
+#include "geometry/Transition.h"
+#include "geometry/Wall.h"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+TEST_CASE("geometry/LocationRaster", "[geometry][LocationRaster]")
+{
+    // an L shaped area
+    std::vector<Line> boundary{
+        Line(Point(0, 0), Point(10, 0), 0),
+        Line(Point(10, 0), Point(10, 4), 0),
+        Line(Point(10, 4), Point(4, 4), 0),
+        Line(Point(4, 4), Point(4, 10), 0),
+        Line(Point(4, 10), Point(0, 10), 0),
+        Line(Point(0, 10), Point(0, 0), 0)};
+    auto isInside = [](const Point & p) {
+        return p._x > 0 && p._y > 0 && ((p._x < 10 && p._y < 4) || (p._x < 4 && p._y < 10));
+    };
+
+    SECTION("Not built")
+    {
+        LocationRaster raster;
+        REQUIRE_FALSE(raster.IsBuilt());
+        REQUIRE(raster.GetState(Point(2, 2)) == LocationRaster::State::BOUNDARY);
+
+        raster.Build({}, isInside);
+        REQUIRE_FALSE(raster.IsBuilt());
+
+        // the tolerance of a very short segment covers more than a cell
+        raster.Build({Line(Point(1, 1), Point(1, 1.00001), 0)}, isInside);
+        REQUIRE_FALSE(raster.IsBuilt());
+    }
+
+    SECTION("Same result as the exact test")
+    {
+        LocationRaster raster;
+        raster.Build(boundary, isInside);
+        REQUIRE(raster.IsBuilt());
+        REQUIRE(raster.GetState(Point(2, 2)) == LocationRaster::State::INSIDE);
+        REQUIRE(raster.GetState(Point(7, 7)) == LocationRaster::State::OUTSIDE);
+        REQUIRE(raster.GetState(Point(50, -50)) == LocationRaster::State::OUTSIDE);
+        REQUIRE(raster.GetState(Point(4, 7)) == LocationRaster::State::BOUNDARY);
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> coordinate(-2., 12.);
+        int cached = 0;
+        for(int i = 0; i < 10000; ++i) {
+            const Point pos(coordinate(generator), coordinate(generator));
+            const auto state = raster.GetState(pos);
+            if(state != LocationRaster::State::BOUNDARY) {
+                REQUIRE((state == LocationRaster::State::INSIDE) == isInside(pos));
+                ++cached;
+            }
+        }
+        // only the cells along the boundary are left to the exact test
+        REQUIRE(cached > 8500);
+
+        raster.Clear();
+        REQUIRE_FALSE(raster.IsBuilt());
+    }
+}
+
+TEST_CASE("geometry/LocationRaster/SubRoom", "[geometry][LocationRaster]")
+{
+    NormalSubRoom subroom;
+    subroom.AddWall(Wall(Point(0, 0), Point(10, 0)));
+    subroom.AddWall(Wall(Point(10, 0), Point(10, 4)));
+    subroom.AddWall(Wall(Point(10, 4), Point(4, 4)));
+    subroom.AddWall(Wall(Point(4, 4), Point(4, 10)));
+    subroom.AddWall(Wall(Point(0, 10), Point(0, 0)));
+
+    Transition door;
+    door.SetPoint1(Point(4, 10));
+    door.SetPoint2(Point(0, 10));
+    subroom.AddTransition(&door);
+
+    auto * obstacle = new Obstacle();
+    obstacle->AddWall(Wall(Point(1, 1), Point(2, 1)));
+    obstacle->AddWall(Wall(Point(2, 1), Point(2, 2)));
+    obstacle->AddWall(Wall(Point(2, 2), Point(1, 2)));
+    obstacle->AddWall(Wall(Point(1, 2), Point(1, 1)));
+    obstacle->ConvertLineToPoly();
+    subroom.AddObstacle(obstacle);
+
+    std::vector<Line *> goals{&door};
+    REQUIRE(subroom.ConvertLineToPoly(goals));
+    subroom.CreateBoostPoly();
+
+    // points on the door, the walls and the obstacle and random points
+    std::vector<Point> points{
+        Point(2, 10), Point(4, 7), Point(1.5, 1), Point(1.5, 1.5), Point(0.5, 0.5), Point(7, 7)};
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-2., 12.);
+    for(int i = 0; i < 10000; ++i) {
+        points.emplace_back(coordinate(generator), coordinate(generator));
+    }
+    std::vector<bool> expected;
+    for(const auto & p : points) {
+        expected.push_back(subroom.IsInSubRoom(p));
+    }
+
+    subroom.UpdateLocationRaster();
+    for(std::size_t i = 0; i < points.size(); ++i) {
+        REQUIRE(subroom.IsInSubRoom(points[i]) == expected[i]);
+    }
+    REQUIRE(subroom.IsInSubRoom(Point(2, 10)));
+    REQUIRE_FALSE(subroom.IsInSubRoom(Point(1.5, 1.5)));
+}
+
+TEST_CASE("geometry/LocationRaster/Stair", "[geometry][LocationRaster]")
+{
+    // stairs inherit NormalSubRoom::IsInSubRoom() and read the raster of their shifted polygon
+    Stair stair;
+    stair.AddWall(Wall(Point(0, 0), Point(4, 0)));
+    stair.AddWall(Wall(Point(4, 2), Point(0, 2)));
+    stair.SetUp(Point(4, 1));
+    stair.SetDown(Point(0, 1));
+
+    Transition lower;
+    lower.SetPoint1(Point(0, 2));
+    lower.SetPoint2(Point(0, 0));
+    stair.AddTransition(&lower);
+    Transition upper;
+    upper.SetPoint1(Point(4, 0));
+    upper.SetPoint2(Point(4, 2));
+    stair.AddTransition(&upper);
+
+    std::vector<Line *> goals{&lower, &upper};
+    REQUIRE(stair.ConvertLineToPoly(goals));
+    stair.CreateBoostPoly();
+
+    std::vector<Point> points{Point(0, 1), Point(4, 1), Point(2, 0), Point(2, 1), Point(0, 0)};
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-1., 5.);
+    for(int i = 0; i < 10000; ++i) {
+        points.emplace_back(coordinate(generator), coordinate(generator) - 1.);
+    }
+    std::vector<bool> expected;
+    for(const auto & p : points) {
+        expected.push_back(stair.IsInSubRoom(p));
+    }
+
+    stair.UpdateLocationRaster();
+    for(std::size_t i = 0; i < points.size(); ++i) {
+        REQUIRE(stair.IsInSubRoom(points[i]) == expected[i]);
+    }
+    REQUIRE(stair.IsInSubRoom(Point(2, 1)));
+    REQUIRE_FALSE(stair.IsInSubRoom(Point(2, 3)));
+}
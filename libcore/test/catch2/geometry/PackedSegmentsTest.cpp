@@ -0,0 +1,90 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "geometry/PackedSegments.h"
+
+#include "geometry/Line.h"
+#include "geometry/Point.h"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+TEST_CASE("geometry/PackedSegments", "[geometry][PackedSegments]")
+{
+    SECTION("FindIntersection")
+    {
+        std::vector<Line> lines{
+            Line(Point(0, 0), Point(10, 0), 0),
+            Line(Point(5, -1), Point(5, 1), 0),
+            Line(Point(2, 0), Point(4, 0), 0),
+            Line(Point(0, 1), Point(10, 1), 0),
+            Line(Point(-1, -1), Point(-1, 1), 0)};
+        PackedSegments segments;
+        for(const auto & line : lines) {
+            segments.Add(line);
+        }
+        REQUIRE(segments.Size() == lines.size());
+
+        REQUIRE(segments.FindIntersection(0, 5, Point(5, -2), Point(5, 2)) == 0);
+        REQUIRE(segments.FindIntersection(1, 5, Point(3, -1), Point(3, 0.5)) == 2);
+        REQUIRE(segments.FindIntersection(3, 5, Point(3, -1), Point(3, 0.5)) == 5);
+        // parallel to all segments but the vertical ones
+        REQUIRE(segments.FindIntersection(0, 5, Point(-2, 0.5), Point(8, 0.5)) == 1);
+        REQUIRE(segments.FindIntersection(0, 5, Point(20, 20), Point(30, 30)) == 5);
+        // 5% of the query segment behind p1 count as intersection
+        REQUIRE(segments.FindIntersection(4, 5, Point(-0.98, 0), Point(0, 0)) == 4);
+        REQUIRE(segments.FindIntersection(4, 5, Point(-0.9, 0), Point(0, 0)) == 5);
+
+        segments.Clear();
+        REQUIRE(segments.Size() == 0);
+    }
+
+    SECTION("Same result as Line::IntersectionWith")
+    {
+        // coordinates on a coarse lattice produce many parallel and touching segments
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<int> coordinate(0, 8);
+        auto randomPoint = [&]() { return Point(coordinate(generator), coordinate(generator)); };
+
+        std::vector<Line> lines;
+        PackedSegments segments;
+        for(int i = 0; i < 101; ++i) {
+            lines.emplace_back(randomPoint(), randomPoint(), 0);
+            segments.Add(lines.back());
+        }
+
+        for(int i = 0; i < 2000; ++i) {
+            const Point p1 = randomPoint();
+            const Point p2 = randomPoint();
+            if(p1 == p2) {
+                continue;
+            }
+            std::size_t expected = lines.size();
+            for(std::size_t s = 0; s < lines.size(); ++s) {
+                REQUIRE(
+                    (segments.FindIntersection(s, s + 1, p1, p2) == s) ==
+                    (lines[s].IntersectionWith(p1, p2) != 0));
+                if(expected == lines.size() && lines[s].IntersectionWith(p1, p2)) {
+                    expected = s;
+                }
+            }
+            REQUIRE(segments.FindIntersection(0, lines.size(), p1, p2) == expected);
+        }
+    }
+}
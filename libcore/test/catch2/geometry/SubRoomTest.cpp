@@ -572,3 +572,59 @@ TEST_CASE("geometry/SubRoom/IsInSubRoom", "[geometry][SubRoom][IsInSubRoom]")
         }
     }
 }
+
+TEST_CASE("geometry/SubRoom/WallDistanceField", "[geometry][SubRoom][WallDistanceField]")
+{
+    Wall wall1;
+    wall1.SetPoint1(Point{-2., -2.});
+    wall1.SetPoint2(Point{2., -2.});
+    Wall wall2;
+    wall2.SetPoint1(Point{-2., 2.});
+    wall2.SetPoint2(Point{2., 2.});
+    auto crossing = new Crossing();
+    crossing->SetPoint1(Point{-2., -2.});
+    crossing->SetPoint2(Point{-2., 2.});
+    auto transition = new Transition();
+    transition->SetID(1);
+    transition->SetPoint1(Point{2., -2.});
+    transition->SetPoint2(Point{2., 2.});
+    NormalSubRoom subRoom;
+    subRoom.SetRoomID(1);
+    subRoom.SetSubRoomID(3);
+    subRoom.AddCrossing(crossing);
+    subRoom.AddTransition(transition);
+    subRoom.AddWall(wall1);
+    subRoom.AddWall(wall2);
+    subRoom.Update();
+    REQUIRE_FALSE(subRoom.GetWallDistanceField().IsBuilt());
+
+    subRoom.UpdateWallDistanceField(1.);
+    REQUIRE(subRoom.GetWallDistanceField().IsBuilt());
+    REQUIRE(subRoom.GetWallDistanceField().Size() == 2);
+
+    SECTION("Changed walls are rebuilt by Update()")
+    {
+        // split the lower wall, the train doors change the walls the same way
+        Wall left;
+        left.SetPoint1(Point{-2., -2.});
+        left.SetPoint2(Point{0., -2.});
+        Wall right;
+        right.SetPoint1(Point{0., -2.});
+        right.SetPoint2(Point{2., -2.});
+        REQUIRE(subRoom.RemoveWall(wall1));
+        REQUIRE(subRoom.AddWall(left));
+        REQUIRE(subRoom.AddWall(right));
+        REQUIRE_FALSE(subRoom.GetWallDistanceField().IsBuilt());
+
+        subRoom.Update();
+        const WallDistanceField & field = subRoom.GetWallDistanceField();
+        REQUIRE(field.IsBuilt());
+        REQUIRE(field.GetCutoff() == Approx(1.));
+        REQUIRE(field.Size() == 3);
+
+        std::vector<Line> found;
+        field.ForEachWallInCutoff(
+            Point{1., -1.5}, [&found](const Line & segment) { found.push_back(segment); });
+        REQUIRE(found == std::vector<Line>{right});
+    }
+}
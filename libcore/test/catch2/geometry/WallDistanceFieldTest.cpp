@@ -0,0 +1,117 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "geometry/WallDistanceField.h"
+
+#include "geometry/Line.h"
+#include "geometry/Point.h"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+TEST_CASE("geometry/WallDistanceField", "[geometry][WallDistanceField]")
+{
+    // a box with a wall in the middle
+    std::vector<Line> walls{
+        Line(Point(0, 0), Point(10, 0), 0),
+        Line(Point(10, 0), Point(10, 10), 0),
+        Line(Point(10, 10), Point(0, 10), 0),
+        Line(Point(0, 10), Point(0, 0), 0),
+        Line(Point(5, 2), Point(5, 8), 0)};
+
+    SECTION("Empty field")
+    {
+        WallDistanceField field;
+        REQUIRE_FALSE(field.IsBuilt());
+
+        field.Build({}, 1.);
+        REQUIRE(field.IsBuilt());
+        int calls = 0;
+        field.ForEachWallInCutoff(Point(0, 0), [&calls](const Line &) { ++calls; });
+        REQUIRE(calls == 0);
+    }
+
+    SECTION("Walls in the cutoff")
+    {
+        WallDistanceField field;
+        field.Build(walls, 1.);
+        REQUIRE(field.Size() == walls.size());
+        REQUIRE(field.GetCutoff() == Approx(1.));
+
+        auto wallsAt = [&field](const Point & pos) {
+            std::vector<Line> found;
+            field.ForEachWallInCutoff(
+                pos, [&found](const Line & segment) { found.push_back(segment); });
+            return found;
+        };
+        REQUIRE(wallsAt(Point(2.5, 0.6)) == std::vector<Line>{walls[0]});
+        REQUIRE(wallsAt(Point(4.6, 5)) == std::vector<Line>{walls[4]});
+        REQUIRE(wallsAt(Point(9.5, 0.5)) == std::vector<Line>{walls[0], walls[1]});
+
+        // far away from all walls and outside of the raster
+        REQUIRE(wallsAt(Point(2.5, 5)).empty());
+        REQUIRE(wallsAt(Point(50, 50)).empty());
+
+        field.Clear();
+        REQUIRE_FALSE(field.IsBuilt());
+        REQUIRE(field.Size() == 0);
+    }
+
+    SECTION("Same walls as testing all walls")
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> coordinate(-5., 25.);
+        std::uniform_real_distribution<double> offset(-2., 2.);
+
+        std::vector<Line> segments;
+        for(int i = 0; i < 200; ++i) {
+            const Point p1(coordinate(generator), coordinate(generator));
+            const Point p2(p1._x + offset(generator), p1._y + offset(generator));
+            segments.emplace_back(p1, p2, 0);
+        }
+        const double cutoff = 1.5;
+        WallDistanceField field;
+        field.Build(segments, cutoff);
+
+        for(int i = 0; i < 2000; ++i) {
+            const Point pos(coordinate(generator), coordinate(generator));
+
+            std::vector<const Line *> expected;
+            for(const auto & segment : segments) {
+                if(segment.DistTo(pos) < cutoff - 1e-9) {
+                    expected.push_back(&segment);
+                }
+            }
+            std::vector<Line> found;
+            field.ForEachWallInCutoff(
+                pos, [&found](const Line & segment) { found.push_back(segment); });
+
+            // every wall within the cutoff is found, in the order of the segments
+            auto next = std::begin(found);
+            for(const Line * segment : expected) {
+                next = std::find(next, std::end(found), *segment);
+                REQUIRE(next != std::end(found));
+            }
+            for(const auto & segment : found) {
+                REQUIRE(segment.DistTo(pos) <= cutoff + 1e-9);
+            }
+        }
+    }
+}
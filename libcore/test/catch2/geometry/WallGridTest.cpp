@@ -0,0 +1,95 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "geometry/WallGrid.h"
+
+#include "geometry/Line.h"
+#include "geometry/Point.h"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+TEST_CASE("geometry/WallGrid", "[geometry][WallGrid]")
+{
+    SECTION("Empty grid")
+    {
+        WallGrid grid;
+        REQUIRE_FALSE(grid.IsBuilt());
+
+        grid.Build({});
+        REQUIRE(grid.IsBuilt());
+        REQUIRE_FALSE(grid.IntersectsAny(Point(0, 0), Point(10, 10)));
+    }
+
+    SECTION("IntersectsAny")
+    {
+        // a box with a wall in the middle
+        std::vector<Line> walls{
+            Line(Point(0, 0), Point(10, 0), 0),
+            Line(Point(10, 0), Point(10, 10), 0),
+            Line(Point(10, 10), Point(0, 10), 0),
+            Line(Point(0, 10), Point(0, 0), 0),
+            Line(Point(5, 2), Point(5, 8), 0)};
+        WallGrid grid;
+        grid.Build(walls);
+        REQUIRE(grid.Size() == walls.size());
+
+        REQUIRE_FALSE(grid.IntersectsAny(Point(1, 1), Point(4, 9)));
+        REQUIRE(grid.IntersectsAny(Point(1, 5), Point(9, 5)));
+        REQUIRE_FALSE(grid.IntersectsAny(Point(1, 1), Point(9, 1)));
+        REQUIRE(grid.IntersectsAny(Point(5, 5), Point(20, 5)));
+
+        // outside of the walls
+        REQUIRE_FALSE(grid.IntersectsAny(Point(20, 20), Point(30, 30)));
+
+        grid.Clear();
+        REQUIRE_FALSE(grid.IsBuilt());
+        REQUIRE(grid.Size() == 0);
+    }
+
+    SECTION("Same result as testing all walls")
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> coordinate(-5., 25.);
+        std::uniform_real_distribution<double> offset(-2., 2.);
+
+        std::vector<Line> walls;
+        for(int i = 0; i < 200; ++i) {
+            const Point p1(coordinate(generator), coordinate(generator));
+            const Point p2(p1._x + offset(generator), p1._y + offset(generator));
+            walls.emplace_back(p1, p2, 0);
+        }
+        WallGrid grid;
+        grid.Build(walls);
+
+        for(int i = 0; i < 2000; ++i) {
+            const Point p1(coordinate(generator), coordinate(generator));
+            // mostly short queries as between neighbouring pedestrians
+            const double scale = i % 10 == 0 ? 10. : 1.;
+            const Point p2(
+                p1._x + scale * offset(generator), p1._y + scale * offset(generator));
+
+            bool expected = false;
+            for(const auto & wall : walls) {
+                expected = expected || wall.IntersectionWith(p1, p2);
+            }
+            REQUIRE(grid.IntersectsAny(p1, p2) == expected);
+        }
+    }
+}
@@ -0,0 +1,241 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "math/GCFMModel.h"
+
+#include "direction/DirectionManager.h"
+#include "direction/walking/DirectionStrategy.h"
+#include "general/Configuration.h"
+#include "general/Macros.h"
+#include "general/OpenMP.h"
+#include "geometry/Building.h"
+#include "geometry/Point.h"
+#include "geometry/Room.h"
+#include "geometry/SubRoom.h"
+#include "geometry/Transition.h"
+#include "geometry/Wall.h"
+#include "pedestrian/Pedestrian.h"
+#include "routing/Router.h"
+
+#include <catch2/catch.hpp>
+#include <memory>
+#include <vector>
+
+namespace
+{
+/// sends every pedestrian to the same exit
+class ExitRouter : public Router
+{
+private:
+    Transition * _exit;
+
+public:
+    explicit ExitRouter(Transition * exit) : Router(1, ROUTING_GLOBAL_SHORTEST), _exit(exit) {}
+
+    int FindExit(Pedestrian * ped) override
+    {
+        ped->SetExitIndex(_exit->GetUniqueID());
+        ped->SetExitLine(_exit);
+        return _exit->GetUniqueID();
+    }
+
+    bool Init(Building *) override { return true; }
+};
+
+struct State {
+    std::vector<Point> pos;
+    std::vector<Point> v;
+    /// position of the pedestrian ahead of the crowd after every step
+    std::vector<Point> leader;
+};
+
+/// ID of the pedestrian ahead of the crowd
+constexpr int LEADER_ID = 31;
+
+/**
+ * Moves a crowd of 30 pedestrians and one pedestrian ahead of them through a corridor with the
+ * GCFM.
+ * @param pairwise evaluate the repulsion of each pair of pedestrians once
+ * @param threads number of OpenMP threads
+ * @param steps number of time steps
+ * @param deltaT time step
+ * @param maxSubSteps maximum number of sub-steps of the agents in contact
+ * @return positions and velocities of the pedestrians after the steps
+ */
+State Simulate(bool pairwise, int threads, int steps, double deltaT = 0.01, int maxSubSteps = 1)
+{
+    // (0, 4) |----------| (10, 4)
+    //        |          +
+    //        |          +
+    // (0, 0) |----------| (10, 0)
+    Wall bottom;
+    bottom.SetPoint1(Point{0., 0.});
+    bottom.SetPoint2(Point{10., 0.});
+    Wall top;
+    top.SetPoint1(Point{0., 4.});
+    top.SetPoint2(Point{10., 4.});
+    Wall left;
+    left.SetPoint1(Point{0., 0.});
+    left.SetPoint2(Point{0., 4.});
+    auto exit = new Transition();
+    exit->SetID(1);
+    exit->SetPoint1(Point{10., 0.});
+    exit->SetPoint2(Point{10., 4.});
+
+    auto subroom = new NormalSubRoom();
+    subroom->SetRoomID(1);
+    subroom->SetSubRoomID(1);
+    subroom->AddTransition(exit);
+    subroom->AddWall(bottom);
+    subroom->AddWall(top);
+    subroom->AddWall(left);
+    subroom->ConvertLineToPoly(std::vector<Line *>{exit});
+    subroom->CreateBoostPoly();
+
+    auto room = new Room();
+    room->SetID(1);
+    room->AddSubRoom(subroom);
+    room->AddTransitionID(exit->GetUniqueID());
+
+    Configuration config;
+    Building building;
+    building.SetConfig(&config);
+    building.AddRoom(room);
+    building.AddTransition(exit);
+    exit->SetRoom1(room);
+    REQUIRE(building.InitGeometry());
+    building.InitGrid();
+
+    // a crowd close enough to push each other
+    ExitRouter router(exit);
+    for(int i = 0; i < 6; ++i) {
+        for(int j = 0; j < 5; ++j) {
+            auto ped = new Pedestrian();
+            ped->SetID(5 * i + j + 1);
+            ped->SetBuilding(&building);
+            ped->SetRoomID(1);
+            ped->SetSubRoomID(1);
+            ped->SetPos(Point(1. + 0.55 * i, 0.6 + 0.65 * j + 0.05 * (i % 2)), true);
+            ped->SetV(Point(0.2 + 0.1 * (i % 3), 0.05 * (j - 2)));
+            ped->SetV0Norm(1.34, 1.34, 1.34, 1.34, 1.34, 1.34, 1.34);
+            ped->SetRouter(&router);
+            building.AddPedestrian(ped);
+        }
+    }
+    // walks at its desired speed straight to the exit, the crowd behind it exerts no force
+    auto leader = new Pedestrian();
+    leader->SetID(LEADER_ID);
+    leader->SetBuilding(&building);
+    leader->SetRoomID(1);
+    leader->SetSubRoomID(1);
+    leader->SetPos(Point(8.5, 2.), true);
+    leader->SetV(Point(1.34, 0.));
+    leader->SetV0Norm(1.34, 1.34, 1.34, 1.34, 1.34, 1.34, 1.34);
+    leader->SetRouter(&router);
+    building.AddPedestrian(leader);
+    building.UpdateGrid();
+
+    auto direction = std::make_shared<DirectionManager>();
+    direction->SetDirectionStrategy(std::make_shared<DirectionMiddlePoint>());
+    GCFMModel model(direction, 0.3, 0.2, 2, 2, 0.1, 0.1, 3, 3, 0, pairwise, maxSubSteps);
+    REQUIRE(model.Init(&building));
+
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(threads);
+#endif
+    State state;
+    for(int step = 0; step < steps; ++step) {
+        building.UpdateGrid();
+        model.ComputeNextTimeStep(step * deltaT, deltaT, &building, 0);
+        const Pedestrian * ped = building.GetPedestrian(LEADER_ID);
+        REQUIRE(ped != nullptr);
+        state.leader.push_back(ped->GetPos());
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(maxThreads);
+#endif
+
+    for(const auto * ped : building.GetAllPedestrians()) {
+        state.pos.push_back(ped->GetPos());
+        state.v.push_back(ped->GetV());
+    }
+    return state;
+}
+} // namespace
+
+TEST_CASE("math/GCFMModel/pairwise", "[math][GCFMModel]")
+{
+    SECTION("Same forces as per agent")
+    {
+        // after one step the velocities differ by the forces times the time step
+        const State perAgent = Simulate(false, 1, 1);
+        const State pairwise = Simulate(true, 1, 1);
+        REQUIRE(perAgent.v.size() == 31);
+        REQUIRE(pairwise.v.size() == 31);
+        for(std::size_t p = 0; p < perAgent.v.size(); ++p) {
+            REQUIRE(pairwise.v[p]._x == Approx(perAgent.v[p]._x).margin(1e-12));
+            REQUIRE(pairwise.v[p]._y == Approx(perAgent.v[p]._y).margin(1e-12));
+        }
+    }
+
+    SECTION("Independent of the number of threads")
+    {
+        const State serial   = Simulate(true, 1, 50);
+        const State parallel = Simulate(true, 4, 50);
+        REQUIRE(serial.v.size() == 31);
+        REQUIRE(parallel.v.size() == 31);
+        for(std::size_t p = 0; p < serial.v.size(); ++p) {
+            REQUIRE(parallel.pos[p]._x == serial.pos[p]._x);
+            REQUIRE(parallel.pos[p]._y == serial.pos[p]._y);
+            REQUIRE(parallel.v[p]._x == serial.v[p]._x);
+            REQUIRE(parallel.v[p]._y == serial.v[p]._y);
+        }
+    }
+}
+
+TEST_CASE("math/GCFMModel/subSteps", "[math][GCFMModel]")
+{
+    // five times the usual time step, the crowd pushes hard enough to need sub-steps
+    const double deltaT  = 0.05;
+    const int steps      = 20;
+    const State plain    = Simulate(false, 1, steps, deltaT, 1);
+    const State subSteps = Simulate(false, 1, steps, deltaT, 10);
+
+    SECTION("No agent is removed")
+    {
+        REQUIRE(subSteps.v.size() == 31);
+    }
+
+    SECTION("Agents without contact take the plain step")
+    {
+        REQUIRE(plain.leader.size() == static_cast<std::size_t>(steps));
+        REQUIRE(subSteps.leader.size() == static_cast<std::size_t>(steps));
+        for(int step = 0; step < steps; ++step) {
+            REQUIRE(subSteps.leader[step]._x == plain.leader[step]._x);
+            REQUIRE(subSteps.leader[step]._y == plain.leader[step]._y);
+        }
+        // the leader moved on, the sub-steps changed the crowd by more than J_EPS
+        REQUIRE(subSteps.leader.back()._x > 9.5);
+        bool crowdDiffers = plain.pos.size() != subSteps.pos.size();
+        for(std::size_t p = 0; !crowdDiffers && p < plain.pos.size(); ++p) {
+            crowdDiffers = !(plain.pos[p] == subSteps.pos[p]);
+        }
+        REQUIRE(crowdDiffers);
+    }
+}
@@ -18,7 +18,9 @@
 
 #include "math/Mathematics.h"
 
+#include <algorithm>
 #include <catch2/catch.hpp>
+#include <cmath>
 
 TEST_CASE("math/Mathematics", "[math][Mathematics]")
 {
@@ -31,4 +33,24 @@ TEST_CASE("math/Mathematics", "[math][Mathematics]")
         // zero is positive
         REQUIRE(sign(0.0) == 1);
     }
+
+    SECTION("FastExp")
+    {
+        REQUIRE(FastExp(0) == 1);
+        // multiples of ln(2) evaluate the polynomial close to 0
+        REQUIRE(FastExp(10 * log(2.)) == Approx(1024).epsilon(1e-15));
+
+        // includes the boundaries of the polynomial at +-ln(2)/2
+        double maxRelError = 0;
+        for(double x = -700; x <= 700; x += 0.001) {
+            maxRelError = std::max(maxRelError, std::abs(FastExp(x) / exp(x) - 1));
+        }
+        REQUIRE(maxRelError <= FAST_EXP_MAX_REL_ERROR);
+        // the bound is tight
+        REQUIRE(maxRelError > 0.9 * FAST_EXP_MAX_REL_ERROR);
+
+        // clamped
+        REQUIRE(FastExp(-1000) == FastExp(-700));
+        REQUIRE(FastExp(1000) == FastExp(700));
+    }
 }
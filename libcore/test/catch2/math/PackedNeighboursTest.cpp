@@ -0,0 +1,126 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "math/PackedNeighbours.h"
+
+#include "general/Macros.h"
+#include "geometry/Point.h"
+#include "math/Mathematics.h"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+TEST_CASE("math/PackedNeighbours", "[math][PackedNeighbours]")
+{
+    const double l = 0.4;
+    const double a = 5;
+    const double D = 0.1;
+
+    SECTION("No neighbours")
+    {
+        PackedNeighbours neighbours;
+        REQUIRE(neighbours.Size() == 0);
+        REQUIRE(neighbours.SumRepulsion(l, a, D) == Point(0, 0));
+        REQUIRE(neighbours.MinSpacing(Point(1, 0), l, 100) == 100);
+        REQUIRE(neighbours.FindCloserThan(J_EPS) == 0);
+    }
+
+    SECTION("Neighbours in front")
+    {
+        PackedNeighbours neighbours;
+        // behind
+        neighbours.Add(Point(-1, 0), true, 10);
+        // in front, but too far to the side
+        neighbours.Add(Point(1, 1), true, 11);
+        // in front
+        neighbours.Add(Point(2, 0.1), false, 12);
+        neighbours.Add(Point(3, 0), true, 13);
+        neighbours.Add(Point(0.5, -1), true, 14);
+        neighbours.Add(Point(0.1, 1.5), true, 15);
+        REQUIRE(neighbours.Size() == 6);
+        REQUIRE(neighbours.GetIndex(2) == 12);
+
+        neighbours.SumRepulsion(l, a, D);
+        REQUIRE(neighbours.MinSpacing(Point(1, 0), l, 100) == Point(2, 0.1).Norm());
+        REQUIRE(neighbours.MinSpacing(Point(0, 1), l, 100) == Point(0.1, 1.5).Norm());
+        REQUIRE(neighbours.MinSpacing(Point(0, 1), l, 1) == 1);
+        REQUIRE(neighbours.FindCloserThan(J_EPS) == 6);
+        REQUIRE(neighbours.FindCloserThan(1.2) == 0);
+
+        neighbours.Clear();
+        REQUIRE(neighbours.Size() == 0);
+    }
+
+    SECTION("Same result as the scalar formulas")
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> coordinate(-2, 2);
+        std::bernoulli_distribution visible(0.8);
+
+        PackedNeighbours neighbours;
+        // sizes that are no multiple of the vector width test the scalar tail
+        for(std::size_t size : {1, 2, 3, 5, 8, 13, 31}) {
+            std::vector<Point> offsets;
+            std::vector<bool> repulsive;
+            neighbours.Clear();
+            for(std::size_t i = 0; i < size; ++i) {
+                offsets.emplace_back(coordinate(generator), coordinate(generator));
+                repulsive.push_back(visible(generator));
+                neighbours.Add(offsets.back(), repulsive.back(), i);
+            }
+            const Point direction(coordinate(generator), coordinate(generator));
+
+            Point expectedRepulsion(0, 0);
+            Point expectedFastRepulsion(0, 0);
+            Point magnitude(0, 0);
+            double expectedSpacing = 100;
+            for(std::size_t i = 0; i < size; ++i) {
+                const double distance = offsets[i].Norm();
+                const Point e         = offsets[i].Normalized();
+                if(repulsive[i]) {
+                    const double strength = (l - distance) / D;
+                    expectedRepulsion += e * (-a * exp(strength));
+                    expectedFastRepulsion += e * (-a * FastExp(strength));
+                    // bound of the summed terms for the error of the fast-math mode
+                    magnitude += Point(std::abs(e._x), std::abs(e._y)) * (a * exp(strength));
+                }
+                const double condition1 = direction.ScalarProduct(e);
+                const double condition2 = std::abs(direction.Rotate(0, 1).ScalarProduct(e));
+                if(condition1 >= 0 && condition2 <= l / distance) {
+                    expectedSpacing = std::min(expectedSpacing, distance);
+                }
+            }
+
+            const Point repulsion = neighbours.SumRepulsion(l, a, D);
+            REQUIRE(repulsion._x == expectedRepulsion._x);
+            REQUIRE(repulsion._y == expectedRepulsion._y);
+            REQUIRE(neighbours.MinSpacing(direction, l, 100) == expectedSpacing);
+
+            const Point fastRepulsion = neighbours.SumRepulsion(l, a, D, true);
+            REQUIRE(fastRepulsion._x == expectedFastRepulsion._x);
+            REQUIRE(fastRepulsion._y == expectedFastRepulsion._y);
+            const Point error = fastRepulsion - repulsion;
+            REQUIRE(std::abs(error._x) <= FAST_EXP_MAX_REL_ERROR * magnitude._x);
+            REQUIRE(std::abs(error._y) <= FAST_EXP_MAX_REL_ERROR * magnitude._y);
+            REQUIRE(neighbours.MinSpacing(direction, l, 100) == expectedSpacing);
+        }
+    }
+}
@@ -0,0 +1,182 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+#include "math/VelocityModel.h"
+
+#include "direction/DirectionManager.h"
+#include "direction/walking/DirectionStrategy.h"
+#include "general/Configuration.h"
+#include "geometry/Building.h"
+#include "geometry/Point.h"
+#include "geometry/Room.h"
+#include "geometry/SubRoom.h"
+#include "geometry/Transition.h"
+#include "geometry/Wall.h"
+#include "math/Mathematics.h"
+#include "pedestrian/Ellipse.h"
+#include "pedestrian/Pedestrian.h"
+#include "routing/Router.h"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace
+{
+/// sends every pedestrian to the same exit
+class ExitRouter : public Router
+{
+private:
+    Transition * _exit;
+
+public:
+    explicit ExitRouter(Transition * exit) : Router(1, ROUTING_GLOBAL_SHORTEST), _exit(exit) {}
+
+    int FindExit(Pedestrian * ped) override
+    {
+        ped->SetExitIndex(_exit->GetUniqueID());
+        ped->SetExitLine(_exit);
+        return _exit->GetUniqueID();
+    }
+
+    bool Init(Building *) override { return true; }
+};
+
+/// positions of the pedestrians by ID after every time step
+using Trajectories = std::vector<std::map<int, Point>>;
+
+/**
+ * Moves a crowd of 30 pedestrians through a corridor with the velocity model.
+ * @param fastMath approximate the exponential repulsion
+ * @param steps number of time steps
+ * @return positions of the pedestrians after every step
+ */
+Trajectories Simulate(bool fastMath, int steps)
+{
+    // (0, 4) |----------| (10, 4)
+    //        |          +
+    //        |          +
+    // (0, 0) |----------| (10, 0)
+    Wall bottom;
+    bottom.SetPoint1(Point{0., 0.});
+    bottom.SetPoint2(Point{10., 0.});
+    Wall top;
+    top.SetPoint1(Point{0., 4.});
+    top.SetPoint2(Point{10., 4.});
+    Wall left;
+    left.SetPoint1(Point{0., 0.});
+    left.SetPoint2(Point{0., 4.});
+    auto exit = new Transition();
+    exit->SetID(1);
+    exit->SetPoint1(Point{10., 0.});
+    exit->SetPoint2(Point{10., 4.});
+
+    auto subroom = new NormalSubRoom();
+    subroom->SetRoomID(1);
+    subroom->SetSubRoomID(1);
+    subroom->AddTransition(exit);
+    subroom->AddWall(bottom);
+    subroom->AddWall(top);
+    subroom->AddWall(left);
+    subroom->ConvertLineToPoly(std::vector<Line *>{exit});
+    subroom->CreateBoostPoly();
+
+    auto room = new Room();
+    room->SetID(1);
+    room->AddSubRoom(subroom);
+    room->AddTransitionID(exit->GetUniqueID());
+
+    Configuration config;
+    Building building;
+    building.SetConfig(&config);
+    building.AddRoom(room);
+    building.AddTransition(exit);
+    exit->SetRoom1(room);
+    REQUIRE(building.InitGeometry());
+    building.InitGrid();
+
+    // circles of radius 0.15 close enough to repel each other
+    ExitRouter router(exit);
+    for(int i = 0; i < 6; ++i) {
+        for(int j = 0; j < 5; ++j) {
+            auto ped = new Pedestrian();
+            ped->SetID(5 * i + j + 1);
+            ped->SetBuilding(&building);
+            ped->SetRoomID(1);
+            ped->SetSubRoomID(1);
+            ped->SetPos(Point(1. + 0.5 * i, 0.8 + 0.6 * j + 0.1 * (i % 2)), true);
+            ped->SetV0Norm(1.34, 1.34, 1.34, 1.34, 1.34, 1.34, 1.34);
+            ped->SetT(1);
+            JEllipse E = ped->GetEllipse();
+            E.SetAmin(0.15);
+            E.SetAv(0);
+            E.SetBmin(0.15);
+            E.SetBmax(0.15);
+            ped->SetEllipse(E);
+            ped->SetRouter(&router);
+            building.AddPedestrian(ped);
+        }
+    }
+    building.UpdateGrid();
+
+    auto direction = std::make_shared<DirectionManager>();
+    direction->SetDirectionStrategy(std::make_shared<DirectionMiddlePoint>());
+    VelocityModel model(direction, 5, 0.1, 5, 0.02, 0, fastMath);
+    REQUIRE(model.Init(&building));
+
+    Trajectories trajectories;
+    const double deltaT = 0.01;
+    for(int step = 0; step < steps; ++step) {
+        building.UpdateGrid();
+        model.ComputeNextTimeStep(step * deltaT, deltaT, &building, 0);
+        std::map<int, Point> positions;
+        for(const auto * ped : building.GetAllPedestrians()) {
+            positions[ped->GetID()] = ped->GetPos();
+        }
+        REQUIRE(positions.size() == 30);
+        trajectories.push_back(positions);
+    }
+    return trajectories;
+}
+} // namespace
+
+TEST_CASE("math/VelocityModel/fastMath", "[math][VelocityModel]")
+{
+    // one second, long enough for the differences to add up, too short for them to change the
+    // neighbour in front of an agent, which separates the trajectories by centimetres
+    const int steps          = 100;
+    const Trajectories exact = Simulate(false, steps);
+    const Trajectories fast  = Simulate(true, steps);
+
+    // the direction of an agent is e0 plus the repulsion terms, each term has a relative error
+    // below FAST_EXP_MAX_REL_ERROR. In this crowd the terms add up to less than 10 times the length
+    // of the direction, so a step moves an agent by less than 10 * v0 * deltaT * error away from
+    // its exact position. The bound adds up these errors, the interactions must not amplify them.
+    const double bound = 10 * steps * 1.34 * 0.01 * FAST_EXP_MAX_REL_ERROR;
+    double deviation   = 0;
+    for(int step = 0; step < steps; ++step) {
+        REQUIRE(fast[step].size() == exact[step].size());
+        for(const auto & position : exact[step]) {
+            deviation =
+                std::max(deviation, (fast[step].at(position.first) - position.second).Norm());
+        }
+    }
+    REQUIRE(deviation > 0);
+    REQUIRE(deviation < bound);
+}
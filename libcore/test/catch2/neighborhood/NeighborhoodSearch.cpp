@@ -19,7 +19,10 @@
 
 #include "neighborhood/NeighborhoodSearch.h"
 
+#include "geometry/Building.h"
 #include "geometry/Point.h"
+#include "geometry/Room.h"
+#include "geometry/SubRoom.h"
 #include "pedestrian/Pedestrian.h"
 
 #include <algorithm>
@@ -84,4 +87,277 @@ TEST_CASE("neighborhood/NeighborSearch", "[neighborhood][neightor-search]")
         neighborhood = neighborhood_search.GetNeighbourhood(&special_ped);
         REQUIRE_THAT(ped_pointers, Catch::Matchers::UnorderedEquals(neighborhood));
     }
+
+    SECTION("ForEachNeighbour")
+    {
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 2.2);
+
+        std::vector<Pedestrian> pedestrians(4);
+        pedestrians[0].SetPos(Point(1, 1));
+        pedestrians[1].SetPos(Point(1.5, 1));
+        pedestrians[2].SetPos(Point(3, 1));
+        pedestrians[3].SetPos(Point(9, 9));
+
+        std::vector<Pedestrian *> ped_pointers;
+        for(auto & ped : pedestrians) {
+            ped_pointers.push_back(&ped);
+        }
+        neighborhood_search.Update(ped_pointers);
+
+        std::vector<Pedestrian *> visited;
+        neighborhood_search.ForEachNeighbour(
+            &pedestrians[0], [&visited](Pedestrian * ped) { visited.push_back(ped); });
+        REQUIRE_THAT(visited, Catch::Matchers::UnorderedEquals(std::vector<Pedestrian *>{
+                                  &pedestrians[1], &pedestrians[2]}));
+        REQUIRE_THAT(
+            neighborhood_search.GetNeighbourhood(&pedestrians[0]),
+            Catch::Matchers::UnorderedEquals(visited));
+
+        visited.clear();
+        neighborhood_search.ForEachNeighbour(
+            &pedestrians[0], 1., [&visited](Pedestrian * ped) { visited.push_back(ped); });
+        REQUIRE(visited == std::vector<Pedestrian *>{&pedestrians[1]});
+
+        // the radius may cover more than the adjacent cells
+        visited.clear();
+        neighborhood_search.ForEachNeighbour(
+            &pedestrians[0], 12., [&visited](Pedestrian * ped) { visited.push_back(ped); });
+        REQUIRE_THAT(visited, Catch::Matchers::UnorderedEquals(std::vector<Pedestrian *>{
+                                  &pedestrians[1], &pedestrians[2], &pedestrians[3]}));
+    }
+
+    SECTION("Update keeps the order within a cell")
+    {
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 2.2);
+
+        std::vector<Pedestrian> pedestrians(5);
+        std::vector<Pedestrian *> ped_pointers;
+        for(std::size_t i = 0; i < pedestrians.size(); ++i) {
+            pedestrians[i].SetPos(Point(1 + 0.1 * i, 1));
+            ped_pointers.push_back(&pedestrians[i]);
+        }
+        std::reverse(ped_pointers.begin(), ped_pointers.end());
+        neighborhood_search.Update(ped_pointers);
+
+        Pedestrian special_ped;
+        special_ped.SetPos(Point(1, 1));
+        REQUIRE(neighborhood_search.GetNeighbourhood(&special_ped) == ped_pointers);
+
+        // updating again with fewer pedestrians
+        ped_pointers.resize(2);
+        neighborhood_search.Update(ped_pointers);
+        REQUIRE(neighborhood_search.GetNeighbourhood(&special_ped) == ped_pointers);
+    }
+
+    SECTION("ForEachNeighbourIndex")
+    {
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 2.2);
+
+        std::vector<Pedestrian> pedestrians(4);
+        pedestrians[0].SetPos(Point(1, 1));
+        pedestrians[1].SetPos(Point(1.5, 1));
+        pedestrians[2].SetPos(Point(4, 1));
+        pedestrians[3].SetPos(Point(9, 9));
+
+        std::vector<Pedestrian *> ped_pointers;
+        for(auto & ped : pedestrians) {
+            ped_pointers.push_back(&ped);
+        }
+        neighborhood_search.Update(ped_pointers);
+
+        auto neighbours = [&neighborhood_search](std::size_t index) {
+            std::vector<std::size_t> indices;
+            neighborhood_search.ForEachNeighbourIndex(
+                index, [&indices](std::size_t other) { indices.push_back(other); });
+            std::sort(indices.begin(), indices.end());
+            return indices;
+        };
+
+        // without Verlet lists the cells around the pedestrian are visited
+        REQUIRE(neighbours(0) == std::vector<std::size_t>{1, 2});
+        REQUIRE(neighbours(3).empty());
+
+        SECTION("Verlet lists")
+        {
+            neighborhood_search.SetVerletSkin(0.4);
+            neighborhood_search.Update(ped_pointers);
+            REQUIRE(neighborhood_search.GetVerletListBuilds() == 1);
+
+            // only pedestrians within cell size + skin
+            REQUIRE(neighbours(0) == std::vector<std::size_t>{1});
+            REQUIRE(neighbours(1) == std::vector<std::size_t>{0, 2});
+            REQUIRE(neighbours(3).empty());
+
+            // small movements keep the lists
+            pedestrians[0].SetPos(Point(1.1, 1));
+            neighborhood_search.Update(ped_pointers);
+            REQUIRE(neighborhood_search.GetVerletListBuilds() == 1);
+
+            // moving more than half the skin rebuilds the lists
+            pedestrians[2].SetPos(Point(3, 1));
+            neighborhood_search.Update(ped_pointers);
+            REQUIRE(neighborhood_search.GetVerletListBuilds() == 2);
+            REQUIRE(neighbours(0) == std::vector<std::size_t>{1, 2});
+
+            // removing a pedestrian rebuilds the lists
+            ped_pointers.pop_back();
+            neighborhood_search.Update(ped_pointers);
+            REQUIRE(neighborhood_search.GetVerletListBuilds() == 3);
+            REQUIRE(neighbours(2) == std::vector<std::size_t>{0, 1});
+        }
+    }
+
+    SECTION("GetNearestNeighbours")
+    {
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 1);
+
+        std::vector<Pedestrian> pedestrians(5);
+        pedestrians[0].SetPos(Point(5, 5));
+        pedestrians[1].SetPos(Point(5.5, 5));
+        pedestrians[2].SetPos(Point(7, 5));
+        pedestrians[3].SetPos(Point(5, 1));
+        pedestrians[4].SetPos(Point(0.5, 9.5));
+
+        std::vector<Pedestrian *> ped_pointers;
+        for(auto & ped : pedestrians) {
+            ped_pointers.push_back(&ped);
+        }
+        neighborhood_search.Update(ped_pointers);
+
+        REQUIRE(
+            neighborhood_search.GetNearestNeighbours(Point(5, 5), -1, 2) ==
+            std::vector<Pedestrian *>{&pedestrians[0], &pedestrians[1]});
+
+        // the pedestrian itself is skipped
+        const int id = pedestrians[0].GetID();
+        REQUIRE(
+            neighborhood_search.GetNearestNeighbours(Point(5, 5), id, 3) ==
+            std::vector<Pedestrian *>{&pedestrians[1], &pedestrians[2], &pedestrians[3]});
+
+        // neighbours several cells away are found
+        REQUIRE(
+            neighborhood_search.GetNearestNeighbours(Point(0, 10), -1, 1) ==
+            std::vector<Pedestrian *>{&pedestrians[4]});
+        REQUIRE(neighborhood_search.GetNearestNeighbours(Point(5, 5), id, 10).size() == 4);
+
+        // only pedestrians within maxRadius
+        REQUIRE(
+            neighborhood_search.GetNearestNeighbours(Point(5, 5), id, 10, 2.) ==
+            std::vector<Pedestrian *>{&pedestrians[1], &pedestrians[2]});
+        REQUIRE(neighborhood_search.GetNearestNeighbours(Point(5, 5), id, 0).empty());
+    }
+
+    SECTION("Elevation bands")
+    {
+        // two floors lying above each other
+        Building building;
+        auto * room = new Room();
+        room->SetID(0);
+        for(int floor = 0; floor < 2; ++floor) {
+            auto * subroom = new NormalSubRoom();
+            subroom->SetSubRoomID(floor);
+            subroom->SetPlanEquation(0, 0, 3. * floor);
+            room->AddSubRoom(subroom);
+        }
+        building.AddRoom(room);
+
+        std::vector<Pedestrian> pedestrians(3);
+        pedestrians[0].SetPos(Point(1, 1));
+        pedestrians[0].SetSubRoomID(0);
+        pedestrians[1].SetPos(Point(1.5, 1));
+        pedestrians[1].SetSubRoomID(0);
+        pedestrians[2].SetPos(Point(1, 1));
+        pedestrians[2].SetSubRoomID(1);
+
+        std::vector<Pedestrian *> ped_pointers;
+        for(auto & ped : pedestrians) {
+            ped.SetBuilding(&building);
+            ped.SetRoomID(0);
+            ped_pointers.push_back(&ped);
+        }
+
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 2.2);
+        neighborhood_search.Update(ped_pointers);
+
+        // without bands the floors are mixed up
+        REQUIRE_THAT(
+            neighborhood_search.GetNeighbourhood(&pedestrians[0]),
+            Catch::Matchers::UnorderedEquals(
+                std::vector<Pedestrian *>{&pedestrians[1], &pedestrians[2]}));
+
+        neighborhood_search.SetElevationBands(0, 3, 1);
+        neighborhood_search.Update(ped_pointers);
+
+        REQUIRE(
+            neighborhood_search.GetNeighbourhood(&pedestrians[0]) ==
+            std::vector<Pedestrian *>{&pedestrians[1]});
+        REQUIRE(neighborhood_search.GetNeighbourhood(&pedestrians[2]).empty());
+
+        std::vector<std::size_t> indices;
+        neighborhood_search.ForEachNeighbourIndex(
+            1, [&indices](std::size_t other) { indices.push_back(other); });
+        REQUIRE(indices == std::vector<std::size_t>{0});
+
+        // queries by position only are not filtered
+        std::vector<Pedestrian *> visited;
+        neighborhood_search.ForEachNeighbour(
+            Point(1, 1), -1, [&visited](Pedestrian * ped) { visited.push_back(ped); });
+        REQUIRE_THAT(visited, Catch::Matchers::UnorderedEquals(ped_pointers));
+    }
+
+    SECTION("GetCellBlocks")
+    {
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 2.2);
+
+        // three pedestrians in the cell at (1, 1), two at (5, 1) and one at (9, 9)
+        std::vector<Pedestrian> pedestrians(6);
+        pedestrians[0].SetPos(Point(9, 9));
+        pedestrians[1].SetPos(Point(1, 1));
+        pedestrians[2].SetPos(Point(5, 1));
+        pedestrians[3].SetPos(Point(1.2, 1));
+        pedestrians[4].SetPos(Point(5.2, 1));
+        pedestrians[5].SetPos(Point(1.4, 1));
+
+        std::vector<Pedestrian *> ped_pointers;
+        for(auto & ped : pedestrians) {
+            ped_pointers.push_back(&ped);
+        }
+        neighborhood_search.Update(ped_pointers);
+
+        std::vector<std::size_t> order;
+        std::vector<std::size_t> blockStart;
+        neighborhood_search.GetCellBlocks(2, order, blockStart);
+        REQUIRE(order == std::vector<std::size_t>{1, 3, 5, 2, 4, 0});
+        REQUIRE(blockStart == std::vector<std::size_t>{0, 3, 5, 6});
+
+        // cells are never split, the last block may be smaller
+        neighborhood_search.GetCellBlocks(4, order, blockStart);
+        REQUIRE(blockStart == std::vector<std::size_t>{0, 5, 6});
+
+        neighborhood_search.GetCellBlocks(100, order, blockStart);
+        REQUIRE(blockStart == std::vector<std::size_t>{0, 6});
+
+        neighborhood_search.Update({});
+        neighborhood_search.GetCellBlocks(2, order, blockStart);
+        REQUIRE(order.empty());
+        REQUIRE(blockStart == std::vector<std::size_t>{0});
+    }
+
+    SECTION("GetMortonKey")
+    {
+        NeighborhoodSearch neighborhood_search(0, 10, 0, 10, 1);
+
+        // cell (i, j) holds [i - 1, i) x [j - 1, j) because of the dummy cells
+        REQUIRE(neighborhood_search.GetMortonKey(Point(0.5, 0.5)) == 3);
+        REQUIRE(neighborhood_search.GetMortonKey(Point(0.7, 0.2)) == 3);
+
+        // the cells (2, 2), (3, 2), (2, 3), (3, 3) are consecutive on the curve
+        REQUIRE(neighborhood_search.GetMortonKey(Point(1.5, 1.5)) == 12);
+        REQUIRE(neighborhood_search.GetMortonKey(Point(2.5, 1.5)) == 13);
+        REQUIRE(neighborhood_search.GetMortonKey(Point(1.5, 2.5)) == 14);
+        REQUIRE(neighborhood_search.GetMortonKey(Point(2.5, 2.5)) == 15);
+
+        // positions outside of the grid are mapped to the border cells
+        REQUIRE(neighborhood_search.GetMortonKey(Point(-100, -100)) == 0);
+    }
 }
@@ -0,0 +1,82 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "pedestrian/AgentsKinematics.h"
+
+#include "pedestrian/Pedestrian.h"
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("pedestrian/AgentsKinematics", "[pedestrian][AgentsKinematics]")
+{
+    std::vector<Pedestrian> pedestrians(5);
+    std::vector<Pedestrian *> pedPointers;
+    for(std::size_t i = 0; i < pedestrians.size(); ++i) {
+        Pedestrian & ped = pedestrians[i];
+        ped.SetPos(Point(i, 2. * i), true);
+        ped.SetV(Point(0.5 * i, -0.5 * i));
+        ped.SetRoomID(1);
+        ped.SetSubRoomID(static_cast<int>(i));
+        pedPointers.push_back(&ped);
+    }
+
+    AgentsKinematics kinematics;
+    REQUIRE(kinematics.Empty());
+
+    SECTION("Gather")
+    {
+        kinematics.Gather(pedPointers);
+        REQUIRE(kinematics.Size() == pedestrians.size());
+
+        for(std::size_t slot = 0; slot < kinematics.Size(); ++slot) {
+            const Pedestrian & ped = *pedPointers[slot];
+            REQUIRE(ped.GetKinematicsIndex() == slot);
+            REQUIRE(kinematics._peds[slot] == &ped);
+            REQUIRE(kinematics.GetPos(slot) == ped.GetPos());
+            REQUIRE(kinematics.GetV(slot) == ped.GetV());
+            REQUIRE(kinematics._id[slot] == ped.GetID());
+            REQUIRE(kinematics._radius[slot] == ped.GetEllipse().GetBmax());
+            REQUIRE(kinematics.GetUniqueRoomID(slot) == ped.GetUniqueRoomID());
+        }
+    }
+
+    SECTION("Store")
+    {
+        kinematics.Gather(pedPointers);
+        Pedestrian & ped = pedestrians[2];
+        ped.SetPos(Point(10, 10), true);
+        REQUIRE(kinematics.GetPos(2) != ped.GetPos());
+
+        kinematics.Store(ped.GetKinematicsIndex(), ped);
+        REQUIRE(kinematics.GetPos(2) == ped.GetPos());
+    }
+
+    SECTION("Gather shrinks the store")
+    {
+        kinematics.Gather(pedPointers);
+        pedPointers.erase(pedPointers.begin());
+        kinematics.Gather(pedPointers);
+
+        REQUIRE(kinematics.Size() == pedPointers.size());
+        REQUIRE(pedPointers.front()->GetKinematicsIndex() == 0);
+
+        kinematics.Clear();
+        REQUIRE(kinematics.Empty());
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "pedestrian/PackedEllipses.h"
+
+#include "general/Macros.h"
+#include "geometry/Point.h"
+#include "pedestrian/Ellipse.h"
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("pedestrian/PackedEllipses", "[pedestrian][PackedEllipses]")
+{
+    SECTION("Cases of the Ellipse test")
+    {
+        const double a = 2.0, // semi-axis
+            b          = 1.5; // orthogonal semi-axis
+        JEllipse E1;
+        E1.SetCenter(Point(0, 0));
+        E1.SetV0(1);
+        E1.SetV(Point(0, 0));
+        E1.SetAmin(a);
+        E1.SetBmax(b);
+
+        // centres of E2 and the expected effective distance
+        const std::vector<std::pair<Point, double>> cases{
+            {Point(10, 0), 10 - 2 * a},
+            {Point(-10, 0), 10 - 2 * a},
+            {Point(2 * a, 0), 0},
+            {Point(2 * a - 1., 0), -1},
+            {Point(0, 5), 5 - 2 * b},
+            {Point(0, -5), 5 - 2 * b},
+            {Point(0, 2 * b), 0},
+            {Point(0, -2 * b), 0},
+            {Point(0, -2 * b + b), -b},
+            {Point(0, 2 * b - b), -b},
+            // total overlap
+            {Point(0, 0), -2 * a},
+            {Point(0.001, 0), 0.001 - 2 * a}};
+
+        PackedEllipses ellipses;
+        std::vector<JEllipse> E2s;
+        for(const auto & c : cases) {
+            JEllipse E2;
+            E2.SetCenter(c.first);
+            E2.SetV0(1);
+            E2.SetV(Point(0, 0));
+            E2.SetAmin(a);
+            E2.SetBmax(b);
+            E2s.push_back(E2);
+            ellipses.Add(E2, E2s.size() + 10);
+        }
+        REQUIRE(ellipses.Size() == cases.size());
+        REQUIRE(ellipses.GetIndex(3) == 14);
+
+        std::vector<double> distances;
+        ellipses.EffectiveDistances(E1, distances);
+        REQUIRE(distances.size() == cases.size());
+        for(std::size_t i = 0; i < cases.size(); ++i) {
+            double dist;
+            REQUIRE(distances[i] == E1.EffectiveDistanceToEllipse(E2s[i], &dist));
+            REQUIRE(distances[i] == cases[i].second);
+        }
+
+        ellipses.Clear();
+        REQUIRE(ellipses.Size() == 0);
+        ellipses.EffectiveDistances(E1, distances);
+        REQUIRE(distances.empty());
+    }
+
+    SECTION("Overlapping, rotated and concentric ellipses")
+    {
+        auto ellipse = [](Point center, double a, double b, double cosPhi, double sinPhi) {
+            JEllipse E;
+            E.SetCenter(center);
+            E.SetCosPhi(cosPhi);
+            E.SetSinPhi(sinPhi);
+            E.SetV0(1);
+            E.SetV(Point(0, 0));
+            E.SetAmin(a);
+            E.SetBmax(b);
+            return E;
+        };
+        const JEllipse E1 = ellipse(Point(0, 0), 2, 1.5, 1, 0);
+
+        // E2 and the expected effective distance to E1
+        const std::vector<std::pair<JEllipse, double>> cases{
+            // smaller ellipse overlapping along the semi-axis a of both
+            {ellipse(Point(2, 0), 1, 0.5, 1, 0), -1},
+            // rotated by 90 degrees, the semi-axis a of E2 points to E1
+            {ellipse(Point(0, 2), 1, 0.5, 0, 1), -0.5},
+            // same centre, both are projected onto their semi-axis a
+            {ellipse(Point(0, 0), 1, 0.5, 0, 1), -3},
+            // centres closer than J_EPS count as the same centre
+            {ellipse(Point(0, 0.5 * J_EPS), 1, 0.5, 1, 0), 0.5 * J_EPS - 3},
+            // slightly farther apart the semi-axes b are used
+            {ellipse(Point(0, 2 * J_EPS), 1, 0.5, 1, 0), 2 * J_EPS - 2}};
+
+        PackedEllipses ellipses;
+        std::vector<double> distances;
+        // all cases at once go through the vector kernel, a single one through the scalar tail
+        for(const auto & c : cases) {
+            ellipses.Add(c.first, ellipses.Size());
+        }
+        ellipses.EffectiveDistances(E1, distances);
+        REQUIRE(distances.size() == cases.size());
+        for(std::size_t i = 0; i < cases.size(); ++i) {
+            double dist;
+            REQUIRE(distances[i] == E1.EffectiveDistanceToEllipse(cases[i].first, &dist));
+            REQUIRE(distances[i] == Approx(cases[i].second).margin(1e-12));
+
+            std::vector<double> single;
+            ellipses.Clear();
+            ellipses.Add(cases[i].first, i);
+            ellipses.EffectiveDistances(E1, single);
+            REQUIRE(single.size() == 1);
+            REQUIRE(single[0] == distances[i]);
+        }
+    }
+}
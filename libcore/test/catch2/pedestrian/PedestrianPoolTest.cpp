@@ -0,0 +1,78 @@
+/*
+ * This file is part of JuPedSim.
+ *
+ * JuPedSim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * JuPedSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with JuPedSim. If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#include "pedestrian/PedestrianPool.h"
+
+#include "pedestrian/Pedestrian.h"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+TEST_CASE("pedestrian/PedestrianPool", "[pedestrian][PedestrianPool]")
+{
+    PedestrianPool pool(20, 4);
+    REQUIRE(pool.Capacity() == 0);
+    REQUIRE(pool.Used() == 0);
+
+    SECTION("Allocate grows in slabs")
+    {
+        std::set<void *> slots;
+        for(int i = 0; i < 5; ++i) {
+            void * slot = pool.Allocate();
+            REQUIRE(reinterpret_cast<std::uintptr_t>(slot) % alignof(std::max_align_t) == 0);
+            slots.insert(slot);
+        }
+        REQUIRE(slots.size() == 5);
+        REQUIRE(pool.Used() == 5);
+        REQUIRE(pool.Capacity() == 8);
+
+        for(void * slot : slots) {
+            pool.Free(slot);
+        }
+        REQUIRE(pool.Used() == 0);
+        REQUIRE(pool.Capacity() == 8);
+    }
+
+    SECTION("Free slots are reused")
+    {
+        void * first  = pool.Allocate();
+        void * second = pool.Allocate();
+        pool.Free(first);
+        REQUIRE(pool.Allocate() == first);
+        pool.Free(second);
+        REQUIRE(pool.Allocate() == second);
+        REQUIRE(pool.Capacity() == 4);
+    }
+}
+
+TEST_CASE("pedestrian/PedestrianPool/Pedestrian", "[pedestrian][PedestrianPool]")
+{
+    PedestrianPool & pool  = Pedestrian::GetPool();
+    const std::size_t used = pool.Used();
+
+    auto * ped = new Pedestrian();
+    REQUIRE(pool.Used() == used + 1);
+    delete ped;
+    REQUIRE(pool.Used() == used);
+
+    auto * recycled = new Pedestrian();
+    REQUIRE(recycled == ped);
+    delete recycled;
+}
@@ -18,6 +18,10 @@
 
 #include "pedestrian/Pedestrian.h"
 
+#include "geometry/Building.h"
+#include "geometry/Room.h"
+#include "geometry/SubRoom.h"
+
 #include <catch2/catch.hpp>
 #include <cmath>
 #include <cstdlib>
@@ -43,6 +47,69 @@ TEST_CASE("Pedestrian::UpdateRoom", "[Pedestrian][UpdateRoom]")
     }
 }
 
+TEST_CASE("Pedestrian::GetSubRoom", "[Pedestrian][GetSubRoom]")
+{
+    auto * room = new Room();
+    room->SetID(1);
+    auto * sub11 = new NormalSubRoom();
+    sub11->SetRoomID(1);
+    sub11->SetSubRoomID(1);
+    room->AddSubRoom(sub11);
+    auto * sub12 = new NormalSubRoom();
+    sub12->SetRoomID(1);
+    sub12->SetSubRoomID(2);
+    room->AddSubRoom(sub12);
+
+    Building building;
+    building.AddRoom(room);
+
+    SECTION("Without building")
+    {
+        Pedestrian ped;
+        ped.SetRoomID(1);
+        ped.SetSubRoomID(1);
+        REQUIRE(ped.GetRoom() == nullptr);
+        REQUIRE(ped.GetSubRoom() == nullptr);
+    }
+
+    SECTION("Follows the room and subroom ID")
+    {
+        Pedestrian ped;
+        ped.SetBuilding(&building);
+        ped.SetRoomID(1);
+        ped.SetSubRoomID(1);
+        REQUIRE(ped.GetRoom() == room);
+        REQUIRE(ped.GetSubRoom() == sub11);
+
+        ped.UpdateRoom(1, 2);
+        REQUIRE(ped.GetRoom() == room);
+        REQUIRE(ped.GetSubRoom() == sub12);
+
+        ped.UpdateRoom(-1, -1);
+        REQUIRE(ped.GetRoom() == nullptr);
+        REQUIRE(ped.GetSubRoom() == nullptr);
+    }
+
+    SECTION("Replaced room")
+    {
+        auto * ped = new Pedestrian();
+        ped->SetBuilding(&building);
+        ped->SetRoomID(1);
+        ped->SetSubRoomID(1);
+        building.AddPedestrian(ped);
+
+        auto * newRoom = new Room();
+        newRoom->SetID(1);
+        auto * newSub = new NormalSubRoom();
+        newSub->SetRoomID(1);
+        newSub->SetSubRoomID(1);
+        newRoom->AddSubRoom(newSub);
+        building.AddRoom(newRoom);
+        REQUIRE(ped->GetRoom() == newRoom);
+        REQUIRE(ped->GetSubRoom() == newSub);
+    }
+}
+
 TEST_CASE("Pedestrian::ChangedRoom", "[Pedestrian][ChangedRoom]")
 {
     SECTION("Same room and subroom")
@@ -20,6 +20,7 @@
 #include "SimulationHelper.h"
 
 #include "general/Configuration.h"
+#include "general/OpenMP.h"
 #include "geometry/Crossing.h"
 #include "geometry/Line.h"
 #include "geometry/Room.h"
@@ -27,8 +28,50 @@
 #include "geometry/Transition.h"
 #include "geometry/Wall.h"
 #include "pedestrian/Pedestrian.h"
+#include "routing/Router.h"
+#include "routing/ff_router/ffRouter.h"
+#include "routing/global_shortest/GlobalRouter.h"
+#include "routing/quickest/QuickestPathRouter.h"
 
 #include <catch2/catch.hpp>
+#include <memory>
+
+namespace
+{
+/// target computed from the position, only reads and writes the pedestrian it is asked for
+class PositionRouter : public Router
+{
+public:
+    PositionRouter() : Router(1, ROUTING_GLOBAL_SHORTEST) {}
+
+    int FindExit(Pedestrian * ped) override
+    {
+        const int target = static_cast<int>(ped->GetPos()._x * 10);
+        ped->SetExitIndex(target);
+        return target;
+    }
+
+    bool IsReentrant() const override { return true; }
+
+    bool Init(Building *) override { return true; }
+};
+
+/// numbers its calls, so the targets depend on the order of the calls
+class CountingRouter : public Router
+{
+private:
+    int _calls = 0;
+
+public:
+    CountingRouter() : Router(2, ROUTING_QUICKEST) {}
+
+    int FindExit(Pedestrian *) override { return _calls++; }
+
+    bool Init(Building *) override { return true; }
+
+    int GetCalls() const { return _calls; }
+};
+} // namespace
 
 TEST_CASE(
     "SimulationHelper::UpdatePedestrianRoomInformation",
@@ -1109,6 +1152,130 @@ TEST_CASE("SimulationHelper::FindPassedDoor", "[SimulationHelper][FindPassedDoor
             REQUIRE(passedTrans.value()->GetUniqueID() == trans23->GetUniqueID());
         }
     }
+
+    SECTION("step starts behind the transition")
+    {
+        // Line::IntersectionWith() accepts transitions up to 5% of the step behind its start, the
+        // bounding box of the step has to cover them
+        SECTION("within 5% of the step")
+        {
+            Pedestrian ped;
+            ped.SetRoomID(2);
+            ped.SetSubRoomID(1);
+            ped.SetPos({2.04, -1.2});
+            ped.SetPos({3.04, -1.2});
+            auto passedTrans = SimulationHelper::FindPassedDoor(building, ped);
+            REQUIRE(passedTrans.has_value());
+            REQUIRE(passedTrans.value()->GetUniqueID() == trans12->GetUniqueID());
+        }
+
+        SECTION("more than 5% of the step")
+        {
+            Pedestrian ped;
+            ped.SetRoomID(2);
+            ped.SetSubRoomID(1);
+            ped.SetPos({2.06, -1.2});
+            ped.SetPos({3.06, -1.2});
+            auto passedTrans = SimulationHelper::FindPassedDoor(building, ped);
+            REQUIRE_FALSE(passedTrans.has_value());
+        }
+    }
+
+    SECTION("same results for any number of threads")
+    {
+        // steps of 0.6 m along the corridor, some cross a crossing, the transition or the exit
+        struct Result {
+            std::vector<int> changed;
+            std::vector<int> outside;
+            std::vector<int> notRelocated;
+            std::vector<int> rooms;
+            int usage12;
+            int usage23;
+        };
+        auto run = [&](int threads) {
+            std::vector<std::unique_ptr<Pedestrian>> owner;
+            std::vector<Pedestrian *> peds;
+            for(int i = 0; i < 300; ++i) {
+                const Point from{-9.5 + 0.05 * i, -1.8 + 0.012 * i};
+                const auto * subroom = from._x < -6. ? sub11 :
+                                       from._x < -2. ? sub12 :
+                                       from._x < 2.  ? sub13 :
+                                                       sub21;
+                owner.push_back(std::make_unique<Pedestrian>());
+                Pedestrian * ped = owner.back().get();
+                ped->SetID(i + 1);
+                ped->SetPos(from, true);
+                ped->SetRoomID(subroom->GetRoomID());
+                ped->SetSubRoomID(subroom->GetSubRoomID());
+                ped->SetSubRoomUID(subroom->GetUID());
+                ped->SetPos(from + Point{0.6, 0.});
+                peds.push_back(ped);
+            }
+
+            const int usage12 = trans12->GetDoorUsage();
+            const int usage23 = trans23->GetDoorUsage();
+#ifdef _OPENMP
+            const int maxThreads = omp_get_max_threads();
+            omp_set_num_threads(threads);
+#endif
+            auto [changed, notRelocated] =
+                SimulationHelper::UpdatePedestriansLocations(building, peds);
+            auto outside = SimulationHelper::FindPedestriansOutside(building, notRelocated);
+            SimulationHelper::UpdateFlowAtDoors(building, changed);
+#ifdef _OPENMP
+            omp_set_num_threads(maxThreads);
+#endif
+
+            auto ids = [](const std::vector<Pedestrian *> & list) {
+                std::vector<int> result;
+                for(const auto * ped : list) {
+                    result.push_back(ped->GetID());
+                }
+                return result;
+            };
+            Result result{
+                ids(changed),
+                ids(outside),
+                ids(notRelocated),
+                {},
+                trans12->GetDoorUsage() - usage12,
+                trans23->GetDoorUsage() - usage23};
+            for(const auto * ped : peds) {
+                result.rooms.push_back(ped->GetUniqueRoomID());
+            }
+            return result;
+        };
+
+        const Result serial = run(1);
+        // the relocation, the exit and the door usage are all covered
+        REQUIRE_FALSE(serial.changed.empty());
+        REQUIRE_FALSE(serial.outside.empty());
+        REQUIRE(serial.usage12 == static_cast<int>(serial.changed.size()));
+        REQUIRE(serial.usage23 == 0);
+
+        const Result parallel = run(4);
+        REQUIRE(parallel.changed == serial.changed);
+        REQUIRE(parallel.outside == serial.outside);
+        REQUIRE(parallel.notRelocated == serial.notRelocated);
+        REQUIRE(parallel.rooms == serial.rooms);
+        REQUIRE(parallel.usage12 == serial.usage12);
+        REQUIRE(parallel.usage23 == serial.usage23);
+    }
+
+    SECTION("transitions of the rooms")
+    {
+        auto transitions = SimulationHelper::CollectRoomTransitions(building);
+        REQUIRE(transitions.size() == 2);
+        REQUIRE(transitions.at(1).size() == 1);
+        REQUIRE(transitions.at(1)[0].transition == trans12);
+        REQUIRE(transitions.at(1)[0].xMin == Approx(2.));
+        REQUIRE(transitions.at(1)[0].yMin == Approx(-2.));
+        REQUIRE(transitions.at(1)[0].xMax == Approx(2.));
+        REQUIRE(transitions.at(1)[0].yMax == Approx(2.));
+        REQUIRE(transitions.at(2).size() == 2);
+        REQUIRE(transitions.at(2)[0].transition == trans12);
+        REQUIRE(transitions.at(2)[1].transition == trans23);
+    }
 }
 
 TEST_CASE("SimulationHelper::RemovePedestrians", "[SimulationHelper][RemovePedestrians]")
@@ -1211,3 +1378,62 @@ TEST_CASE("SimulationHelper::RemovePedestrians", "[SimulationHelper][RemovePedes
         REQUIRE_THAT(building.GetAllPedestrians(), Catch::Matchers::UnorderedEquals(pedsRemaining));
     }
 }
+
+TEST_CASE(
+    "SimulationHelper::FindReentrantRoutes",
+    "[SimulationHelper][FindReentrantRoutes]")
+{
+    SECTION("Reentrant routers")
+    {
+        Configuration config;
+        REQUIRE(FFRouter(1, ROUTING_FF_GLOBAL_SHORTEST, false, &config).IsReentrant());
+        // the quickest strategy flags the router for a recalculation in FindExit()
+        REQUIRE_FALSE(FFRouter(2, ROUTING_FF_QUICKEST, false, &config).IsReentrant());
+        REQUIRE(GlobalRouter(3, ROUTING_GLOBAL_SHORTEST).IsReentrant());
+        REQUIRE_FALSE(QuickestPathRouter(4, ROUTING_QUICKEST).IsReentrant());
+        REQUIRE_FALSE(CountingRouter().IsReentrant());
+    }
+
+    SECTION("Same routes as the serial routing")
+    {
+        PositionRouter reentrant;
+        CountingRouter serial;
+        std::vector<std::unique_ptr<Pedestrian>> owner;
+        std::vector<Pedestrian *> peds;
+        for(int i = 0; i < 200; ++i) {
+            owner.push_back(std::make_unique<Pedestrian>());
+            Pedestrian * ped = owner.back().get();
+            ped->SetID(i + 1);
+            ped->SetPos(Point(0.1 * i, 0.), true);
+            ped->SetRouter(i % 3 == 0 ? static_cast<Router *>(&serial) : &reentrant);
+            peds.push_back(ped);
+        }
+
+        std::vector<int> expected;
+        for(auto * ped : peds) {
+            expected.push_back(ped->GetRouter() == &reentrant ? ped->FindRoute() : -1);
+        }
+
+        for(int threads : {1, 4}) {
+#ifdef _OPENMP
+            const int maxThreads = omp_get_max_threads();
+            omp_set_num_threads(threads);
+#endif
+            const auto targets = SimulationHelper::FindReentrantRoutes(peds);
+#ifdef _OPENMP
+            omp_set_num_threads(maxThreads);
+#endif
+            REQUIRE(targets.size() == peds.size());
+            for(std::size_t i = 0; i < peds.size(); ++i) {
+                if(peds[i]->GetRouter() == &reentrant) {
+                    REQUIRE(targets[i] == expected[i]);
+                    REQUIRE(peds[i]->GetExitIndex() == expected[i]);
+                } else {
+                    REQUIRE_FALSE(targets[i]);
+                }
+            }
+        }
+        // the routes of the other routers are left to the serial loop
+        REQUIRE(serial.GetCalls() == 0);
+    }
+}
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+##################################################################################
+# Check if the evacuation with fast_math agrees with the exact evacuation.       #
+# The small differences of the repulsion grow in the crowd, so the trajectories  #
+# are not compared agent by agent, see the unit test of the VelocityModel.       #
+##################################################################################
+import os
+from sys import argv, path
+import logging
+import numpy as np
+
+utestdir = os.path.abspath(os.path.dirname(os.path.dirname(path[0])))
+path.append(utestdir)
+
+from utils import SUCCESS, FAILURE, parse_file
+from JPSRunTest import JPSRunTestDriver
+
+# largest difference between the evacuation times of both modes in s
+max_evacuation_time_difference = 0.5
+
+
+def runtest(inifile, trajfile):
+    fps, N, traj = parse_file(trajfile)
+    return inifile, fps, traj
+
+
+def compare(results):
+    success = True
+
+    modes = {}
+    for inifile, fps, traj in results:
+        modes["fast_math_true" in inifile] = (fps, traj)
+    if len(modes) != 2:
+        logging.error('Expected one run with and one run without fast_math, got {}.'
+                      .format([result[0] for result in results]))
+        exit(FAILURE)
+
+    fps, exact = modes[False]
+    _, fast = modes[True]
+
+    exact_agents = np.unique(exact[:, 0]).size
+    fast_agents = np.unique(fast[:, 0]).size
+    if exact_agents != fast_agents:
+        success = False
+        logging.error('{} agents with fast_math, {} without.'.format(fast_agents, exact_agents))
+
+    exact_time = np.max(exact[:, 1]) / fps
+    fast_time = np.max(fast[:, 1]) / fps
+    logging.info('Evacuation time: exact {:.2f} s, fast_math {:.2f} s'
+                 .format(exact_time, fast_time))
+    if np.abs(exact_time - fast_time) > max_evacuation_time_difference:
+        success = False
+        logging.error('Evacuation times differ by {:.2f} s, more than {} s.'
+                      .format(np.abs(exact_time - fast_time), max_evacuation_time_difference))
+
+    return success
+
+
+if __name__ == "__main__":
+    test = JPSRunTestDriver(1, argv0=argv[0], testdir=path[0], utestdir=utestdir, jpscore=argv[1])
+    results = test.run_test(testfunction=runtest)
+    if not compare(results):
+        logging.info("%s exits with FAILURE" % (argv[0]))
+        exit(FAILURE)
+    logging.info("%s exits with SUCCESS" % (argv[0]))
+    exit(SUCCESS)
@@ -37,7 +37,9 @@ tags = ['tmax',
         'geometry',
         'exit_crossing_strategy',
         'num_threads',
-        'stepsize']
+        'stepsize',
+        'fast_math',
+        'max_substeps']
 
 # format tag-attribute
 attributes_tags = ['group-pre_movement_mean',
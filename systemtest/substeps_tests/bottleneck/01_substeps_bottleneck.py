@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+##################################################################################
+# Check that the GCFM stays stable at a five times larger time step when the     #
+# agents in contact take sub-steps.                                              #
+##################################################################################
+import os
+from sys import argv, path
+import logging
+import numpy as np
+
+utestdir = os.path.abspath(os.path.dirname(os.path.dirname(path[0])))
+path.append(utestdir)
+
+from utils import SUCCESS, FAILURE, parse_file
+from JPSRunTest import JPSRunTestDriver
+
+# number of agents in master_ini.xml
+number_of_agents = 150
+# x-coordinate of the exit, agents removed for their high velocity disappear before it
+x_exit = 8
+# largest distance in m of the last position of an agent to the exit
+max_distance_to_exit = 0.5
+# largest relative difference between the evacuation times of both time steps
+max_evacuation_time_difference = 0.1
+
+
+def runtest(inifile, trajfile):
+    fps, N, traj = parse_file(trajfile)
+    return inifile, fps, traj
+
+
+def left_through_exit(traj):
+    """
+    returns True if every agent was last seen at the exit
+    """
+    success = True
+    ids = np.unique(traj[:, 0])
+    if len(ids) != number_of_agents:
+        logging.error('Expected {} agents, got {}.'.format(number_of_agents, len(ids)))
+        success = False
+    for i in ids:
+        agent = traj[traj[:, 0] == i]
+        last = agent[np.argmax(agent[:, 1])]
+        if x_exit - last[2] > max_distance_to_exit:
+            logging.error('Agent {:d} disappeared at ({:.2f}, {:.2f}), away from the exit.'
+                          .format(int(i), last[2], last[3]))
+            success = False
+    return success
+
+
+def compare(results):
+    success = True
+
+    steps = {}
+    for inifile, fps, traj in results:
+        steps["stepsize_0.05" in inifile] = (fps, traj)
+    if len(steps) != 2:
+        logging.error('Expected one run with the small and one with the large time step, got {}.'
+                      .format([result[0] for result in results]))
+        exit(FAILURE)
+
+    evacuation_times = []
+    for large in [False, True]:
+        fps, traj = steps[large]
+        if not left_through_exit(traj):
+            success = False
+        evacuation_times.append(np.max(traj[:, 1]) / fps)
+    small_time, large_time = evacuation_times
+    logging.info('Evacuation time: stepsize 0.01 {:.2f} s, stepsize 0.05 {:.2f} s'
+                 .format(small_time, large_time))
+    difference = np.abs(large_time - small_time) / small_time
+    if difference > max_evacuation_time_difference:
+        success = False
+        logging.error('Evacuation times differ by {:.1%}, more than {:.0%}.'
+                      .format(difference, max_evacuation_time_difference))
+
+    return success
+
+
+if __name__ == "__main__":
+    test = JPSRunTestDriver(1, argv0=argv[0], testdir=path[0], utestdir=utestdir, jpscore=argv[1])
+    results = test.run_test(testfunction=runtest)
+    if not compare(results):
+        logging.info("%s exits with FAILURE" % (argv[0]))
+        exit(FAILURE)
+    logging.info("%s exits with SUCCESS" % (argv[0]))
+    exit(SUCCESS)
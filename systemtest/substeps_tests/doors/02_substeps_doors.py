@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+##################################################################################
+# Check that the sub-steps of the agents in contact keep the door counts and do  #
+# not change the trajectories of the agents without contact.                    #
+##################################################################################
+import os
+from sys import argv, path
+import logging
+import numpy as np
+
+utestdir = os.path.abspath(os.path.dirname(os.path.dirname(path[0])))
+path.append(utestdir)
+
+from utils import SUCCESS, FAILURE, parse_file
+from JPSRunTest import JPSRunTestDriver
+
+# number of agents passing the main exit, the hall door and the lane exit, see master_ini.xml
+number_of_agents = {0: 100, 1: 100, 2: 1}
+# id of the single agent in the lane, the agents are numbered in the order of the groups
+lane_agent = 101
+
+
+def read_door_usage(trajfile):
+    """
+    returns a dictionary door id -> number of agents that passed the door
+    """
+    usage = {}
+    for door in number_of_agents:
+        # jpscore writes the flow of every used door next to the results of the run
+        flowfile = os.path.join('results', 'flow_exit_id_{}_{}'.format(door, os.path.basename(trajfile)))
+        if not os.path.exists(flowfile):
+            continue
+        flow = np.loadtxt(flowfile, comments='#', ndmin=2)
+        usage[door] = int(flow[-1, 1]) if flow.size else 0
+    return usage
+
+
+def runtest(inifile, trajfile):
+    fps, N, traj = parse_file(trajfile)
+    return inifile, traj, read_door_usage(trajfile)
+
+
+def compare(results):
+    success = True
+
+    runs = {}
+    for inifile, traj, usage in results:
+        runs["max_substeps_10" in inifile] = (traj, usage)
+    if len(runs) != 2:
+        logging.error('Expected one run without and one run with sub-steps, got {}.'
+                      .format([result[0] for result in results]))
+        exit(FAILURE)
+
+    for substeps in [False, True]:
+        traj, usage = runs[substeps]
+        for door, number in number_of_agents.items():
+            if usage.get(door, 0) != number:
+                success = False
+                logging.error('max_substeps {}: door {} counted {} agents, expected {}.'
+                              .format(10 if substeps else 1, door, usage.get(door, 0), number))
+
+    plain = runs[False][0]
+    plain = plain[plain[:, 0] == lane_agent]
+    substeps = runs[True][0]
+    substeps = substeps[substeps[:, 0] == lane_agent]
+    if plain.shape != substeps.shape or not np.array_equal(plain, substeps):
+        success = False
+        logging.error('The trajectory of agent {} without contact differs with sub-steps.'
+                      .format(lane_agent))
+
+    return success
+
+
+if __name__ == "__main__":
+    test = JPSRunTestDriver(2, argv0=argv[0], testdir=path[0], utestdir=utestdir, jpscore=argv[1])
+    results = test.run_test(testfunction=runtest)
+    if not compare(results):
+        logging.info("%s exits with FAILURE" % (argv[0]))
+        exit(FAILURE)
+    logging.info("%s exits with SUCCESS" % (argv[0]))
+    exit(SUCCESS)